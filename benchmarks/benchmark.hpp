@@ -0,0 +1,51 @@
+// Copyright [2024] <@damianWu>
+#ifndef BENCHMARKS_BENCHMARK_HPP_
+#define BENCHMARKS_BENCHMARK_HPP_
+
+#include <fmt/core.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace bench
+{
+using Clock = std::chrono::steady_clock;
+
+template <typename Function>
+double measureSeconds(Function&& function)
+{
+  const auto start{Clock::now()};
+  std::forward<Function>(function)();
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+inline void report(std::string_view name, std::size_t noOfOps, double seconds)
+{
+  const auto ops{static_cast<double>(noOfOps)};
+  fmt::print("{:<56} {:>12} ops {:>10.2f} Mops/s {:>9.2f} ns/op\n", name, noOfOps, ops / seconds / 1e6,
+             seconds * 1e9 / ops);
+}
+
+// Returns argv[index] parsed as number or defaultValue when argument is missing.
+inline std::size_t argOr(int argc, char** argv, int index, std::size_t defaultValue)
+{
+  if (index >= argc)
+  {
+    return defaultValue;
+  }
+  return std::stoull(argv[index]);
+}
+
+// Keeps the compiler from discarding a value computed only for the benchmark.
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+  asm volatile("" : : "m"(value) : "memory");
+}
+}  // namespace bench
+
+#endif  // BENCHMARKS_BENCHMARK_HPP_
@@ -0,0 +1,77 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint64_t;
+
+struct DequeAdapter
+{
+  void enqueue(Item item) { deque.push_back(item); }
+  Item dequeue()
+  {
+    const Item item{deque.front()};
+    deque.pop_front();
+    return item;
+  }
+
+  std::deque<Item> deque;
+};
+
+// Fills queue with noOfItems and drains it, repeated so every size runs about noOfOps operations.
+// Queue object lives through all rounds, so later rounds run on recycled blocks/nodes/ring
+// (BlockQueue keeps every drained block by default).
+template <typename Queue>
+void fillAndDrain(std::string_view name, std::size_t noOfItems, std::size_t noOfOps)
+{
+  Queue queue;
+  const std::size_t noOfRounds{std::max<std::size_t>(1, noOfOps / (2 * noOfItems))};
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        Item checksum{};
+        for (std::size_t round{}; round < noOfRounds; ++round)
+        {
+          for (Item i{}; i < noOfItems; ++i)
+          {
+            queue.enqueue(i);
+          }
+          for (std::size_t i{}; i < noOfItems; ++i)
+          {
+            checksum += queue.dequeue();
+          }
+        }
+        bench::doNotOptimize(checksum);
+      })};
+  bench::report(fmt::format("{} {}", name, noOfItems), 2 * noOfItems * noOfRounds, seconds);
+}
+}  // namespace
+
+// Usage: block_queue_bench [maxItems] [noOfOps]
+int main(int argc, char** argv)
+{
+  const auto maxItems{bench::argOr(argc, argv, 1, 10'000'000)};
+  const auto noOfOps{bench::argOr(argc, argv, 2, 20'000'000)};
+
+  fmt::print("Fill and drain, 1K to {} items, about {} ops per size\n", maxItems, noOfOps);
+  for (std::size_t noOfItems{1'000}; noOfItems <= maxItems; noOfItems *= 10)
+  {
+    fillAndDrain<ch1::queue::QueueImpl<Item>>("QueueImpl (node per item)", noOfItems, noOfOps);
+    fillAndDrain<ch1::queue::QueueImpl<Item, ch1::trace::NoTrace, ch1::it::PoolNodeAllocator>>(
+        "QueueImpl (node pool)", noOfItems, noOfOps);
+    fillAndDrain<ch1::queue::RingQueue<Item>>("RingQueue", noOfItems, noOfOps);
+    fillAndDrain<ch1::queue::BlockQueue<Item>>("BlockQueue", noOfItems, noOfOps);
+    fillAndDrain<DequeAdapter>("std::deque", noOfItems, noOfOps);
+  }
+  return 0;
+}
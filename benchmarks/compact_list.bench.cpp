@@ -0,0 +1,86 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = int32_t;
+
+// glibc chunk of a single node allocation: 8 byte header, 16 byte granularity, 32 bytes minimum
+constexpr std::size_t mallocChunkBytes(std::size_t noOfBytes)
+{
+  return std::max<std::size_t>(32, (noOfBytes + 8 + 15) / 16 * 16);
+}
+
+template <typename List>
+void fill(List& list, std::size_t noOfItems)
+{
+  for (std::size_t i{}; i < noOfItems; ++i)
+  {
+    list.pushRight(static_cast<Item>(i));
+  }
+}
+
+template <typename List, typename ItemOf>
+void iterate(std::string_view name, List& list, std::size_t noOfItems, std::size_t noOfRounds,
+             ItemOf itemOf)
+{
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        int64_t checksum{};
+        for (std::size_t round{}; round < noOfRounds; ++round)
+        {
+          std::for_each(list.begin(), list.end(),
+                        [&](const auto& element) { checksum += itemOf(element); });
+        }
+        bench::doNotOptimize(checksum);
+      })};
+  bench::report(name, noOfItems * noOfRounds, seconds);
+}
+}  // namespace
+
+// Usage: compact_list_bench [noOfItems] [noOfRounds]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 1'000'000)};
+  const auto noOfRounds{bench::argOr(argc, argv, 2, 20)};
+
+  ch1::double_linked_list::DoubleLinkedList<Item> list;
+  ch1::double_linked_list::CompactDoubleLinkedList<Item> compactList;
+  const auto fillSeconds{bench::measureSeconds([&] { fill(list, noOfItems); })};
+  const auto compactFillSeconds{bench::measureSeconds([&] { fill(compactList, noOfItems); })};
+
+  fmt::print("Bytes per {} byte item\n", sizeof(Item));
+  fmt::print("{:<56} {:>6} B\n", "DoubleLinkedList (node + malloc chunk)",
+             mallocChunkBytes(sizeof(ch1::it::DoubleNode<Item>)));
+  fmt::print("{:<56} {:>6} B\n", "CompactDoubleLinkedList (item + 2 x uint32_t links)",
+             sizeof(Item) + 2 * sizeof(uint32_t));
+
+  fmt::print("pushRight, {} items\n", noOfItems);
+  bench::report("DoubleLinkedList", noOfItems, fillSeconds);
+  bench::report("CompactDoubleLinkedList", noOfItems, compactFillSeconds);
+
+  fmt::print("Iteration, {} items x {} rounds\n", noOfItems, noOfRounds);
+  iterate("DoubleLinkedList", list, noOfItems, noOfRounds, [](const auto& node) { return node.item; });
+  iterate("CompactDoubleLinkedList", compactList, noOfItems, noOfRounds, [](Item item) { return item; });
+
+  const auto cloneSeconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t round{}; round < noOfRounds; ++round)
+        {
+          ch1::double_linked_list::CompactDoubleLinkedList<Item> clone{compactList};
+          bench::doNotOptimize(clone);
+        }
+      })};
+  bench::report("CompactDoubleLinkedList copy (per item)", noOfItems * noOfRounds, cloneSeconds);
+  return 0;
+}
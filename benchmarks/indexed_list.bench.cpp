@@ -0,0 +1,60 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint32_t;
+
+// Random item of a list holding noOfItems unique items is moved to the back on every op.
+template <typename List>
+void moveToBack(std::string_view name, std::size_t noOfItems, std::size_t noOfOps)
+{
+  List list;
+  for (Item i{}; i < noOfItems; ++i)
+  {
+    list.pushRight(i);
+  }
+
+  std::mt19937 randomEngine{42};
+  std::uniform_int_distribution<Item> distribution(0, static_cast<Item>(noOfItems - 1));
+  std::vector<Item> items(noOfOps);
+  for (auto& item : items)
+  {
+    item = distribution(randomEngine);
+  }
+
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        for (const auto item : items)
+        {
+          list.remove(item);
+          list.pushRight(item);
+        }
+      })};
+  bench::report(name, noOfOps, seconds);
+}
+}  // namespace
+
+// Usage: indexed_list_bench [noOfItems] [noOfOps]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 100'000)};
+  const auto noOfOps{bench::argOr(argc, argv, 2, 10'000)};
+
+  fmt::print("Move random item to back, {} items, {} ops\n", noOfItems, noOfOps);
+  using ch1::double_linked_list::DoubleLinkedList;
+  using ch1::double_linked_list::IndexedDoubleLinkedList;
+  moveToBack<DoubleLinkedList<Item>>("DoubleLinkedList (linear find)", noOfItems, noOfOps);
+  moveToBack<IndexedDoubleLinkedList<Item>>("IndexedDoubleLinkedList (hash index)", noOfItems, noOfOps);
+  return 0;
+}
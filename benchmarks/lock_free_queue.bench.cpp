@@ -0,0 +1,116 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint64_t;
+
+// Baseline: single threaded queue behind one lock shared by both ends
+class LockedQueue
+{
+public:
+  void enqueue(Item item)
+  {
+    const std::scoped_lock lock{m_mutex};
+    m_queue.enqueue(item);
+  }
+
+  std::optional<Item> tryDequeue()
+  {
+    const std::scoped_lock lock{m_mutex};
+    if (m_queue.isEmpty())
+    {
+      return std::nullopt;
+    }
+    return m_queue.dequeue();
+  }
+
+private:
+  std::mutex m_mutex;
+  ch1::queue::QueueImpl<Item> m_queue;
+};
+
+// noOfProducers threads push noOfItems in total, noOfConsumers threads drain them.
+template <typename Queue>
+void run(std::string_view name, std::size_t noOfProducers, std::size_t noOfConsumers,
+         std::size_t noOfItems)
+{
+  Queue queue;
+  const std::size_t itemsPerProducer{noOfItems / noOfProducers};
+  const std::size_t totalItems{itemsPerProducer * noOfProducers};
+  std::atomic<std::size_t> noOfReceived{};
+
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        std::vector<std::thread> threads;
+        for (std::size_t p{}; p < noOfProducers; ++p)
+        {
+          threads.emplace_back(
+              [&]
+              {
+                for (Item i{}; i < itemsPerProducer; ++i)
+                {
+                  queue.enqueue(i);
+                }
+              });
+        }
+        for (std::size_t c{}; c < noOfConsumers; ++c)
+        {
+          threads.emplace_back(
+              [&]
+              {
+                Item checksum{};
+                while (noOfReceived.load(std::memory_order_relaxed) < totalItems)
+                {
+                  if (const auto item{queue.tryDequeue()})
+                  {
+                    checksum += *item;
+                    noOfReceived.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                  }
+                  std::this_thread::yield();
+                }
+                bench::doNotOptimize(checksum);
+              });
+        }
+        for (auto& thread : threads)
+        {
+          thread.join();
+        }
+      })};
+
+  bench::report(fmt::format("{} {}P x {}C", name, noOfProducers, noOfConsumers), totalItems, seconds);
+}
+}  // namespace
+
+// Usage: lock_free_queue_bench [noOfItems] [maxThreads]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 2'000'000)};
+  const auto maxThreads{bench::argOr(argc, argv, 2, std::max(2U, std::thread::hardware_concurrency()))};
+
+  fmt::print("Scaling producers and consumers up to {} threads each, {} items\n", maxThreads, noOfItems);
+  for (std::size_t producers{1}; producers <= maxThreads; producers *= 2)
+  {
+    for (std::size_t consumers{1}; consumers <= maxThreads; consumers *= 2)
+    {
+      run<ch1::queue::LockFreeQueue<Item>>("LockFreeQueue", producers, consumers, noOfItems);
+      run<LockedQueue>("QueueImpl + mutex", producers, consumers, noOfItems);
+    }
+  }
+  return 0;
+}
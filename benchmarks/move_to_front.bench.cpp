@@ -0,0 +1,142 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+enum class Distribution
+{
+  runs,
+  skewed,
+  uniform
+};
+
+constexpr std::string_view toString(Distribution distribution)
+{
+  switch (distribution)
+  {
+    case Distribution::runs:
+      return "runs";
+    case Distribution::skewed:
+      return "skewed";
+    case Distribution::uniform:
+      return "uniform";
+  }
+  return "";
+}
+
+// Skewed symbols follow geometric distribution (small values frequent), runs repeat the previous
+// symbol 9 times out of 10 like text after BWT does, uniform is the worst case for move to front.
+template <typename Symbol>
+std::vector<Symbol> makeInput(std::size_t size, std::size_t alphabetSize, Distribution distribution)
+{
+  std::mt19937 generator{42};
+  std::geometric_distribution<std::size_t> geometric{0.05};
+  std::uniform_int_distribution<std::size_t> uniform{0, alphabetSize - 1};
+  std::bernoulli_distribution repeat{0.9};
+  std::vector<Symbol> input(size);
+  Symbol previous{};
+  std::ranges::generate(input,
+                        [&]
+                        {
+                          if (distribution == Distribution::runs && repeat(generator))
+                          {
+                            return previous;
+                          }
+                          const auto symbol{distribution == Distribution::uniform
+                                                ? uniform(generator)
+                                                : geometric(generator)};
+                          previous = static_cast<Symbol>(symbol % alphabetSize);
+                          return previous;
+                        });
+  return input;
+}
+
+// Per byte walk, remove and push of a list node as in ex1_3_40.
+void encodeWithList(std::string_view name, const std::vector<uint8_t>& input)
+{
+  ch1::double_linked_list::DoubleLinkedList<uint8_t> list;
+  for (std::size_t byte{}; byte < 256; ++byte)
+  {
+    list.pushRight(static_cast<uint8_t>(byte));
+  }
+  std::vector<uint8_t> output(input.size());
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t i{}; i < input.size(); ++i)
+        {
+          const auto isByte{[byte = input[i]](const auto& node) { return node.item == byte; }};
+          const auto found{std::find_if(list.begin(), list.end(), isByte)};
+          const auto position{std::distance(list.begin(), found)};
+          output[i] = static_cast<uint8_t>(position);
+          list.remove(input[i]);
+          list.pushLeft(input[i]);
+        }
+      })};
+  bench::doNotOptimize(output);
+  bench::report(name, input.size(), seconds);
+}
+
+void encodeBytes(std::string_view name, const std::vector<uint8_t>& input)
+{
+  std::vector<uint8_t> output(input.size());
+  ch1::move_to_front::ByteEncoder encoder;
+  const auto seconds{bench::measureSeconds([&] { encoder.encode(input, output); })};
+  bench::doNotOptimize(output);
+  bench::report(name, input.size(), seconds);
+}
+
+void decodeBytes(std::string_view name, const std::vector<uint8_t>& input)
+{
+  std::vector<uint8_t> encoded(input.size());
+  ch1::move_to_front::ByteEncoder{}.encode(input, encoded);
+  std::vector<uint8_t> output(input.size());
+  ch1::move_to_front::ByteDecoder decoder;
+  const auto seconds{bench::measureSeconds([&] { decoder.decode(encoded, output); })};
+  bench::doNotOptimize(output);
+  bench::report(name, input.size(), seconds);
+}
+
+void encodeAlphabet(std::string_view name, const std::vector<uint32_t>& input, std::size_t alphabetSize)
+{
+  std::vector<uint32_t> output(input.size());
+  ch1::move_to_front::AlphabetEncoder encoder{alphabetSize};
+  const auto seconds{bench::measureSeconds([&] { encoder.encode(input, output); })};
+  bench::doNotOptimize(output);
+  bench::report(name, input.size(), seconds);
+}
+}  // namespace
+
+// Mops/s of the byte codec are MB/s.
+// Usage: move_to_front_bench [noOfBytes] [noOfListBytes]
+int main(int argc, char** argv)
+{
+  const auto noOfBytes{bench::argOr(argc, argv, 1, 64'000'000)};
+  const auto noOfListBytes{bench::argOr(argc, argv, 2, 1'000'000)};
+
+  for (const auto distribution : {Distribution::runs, Distribution::skewed, Distribution::uniform})
+  {
+    const auto bytes{makeInput<uint8_t>(noOfBytes, 256, distribution)};
+    const std::vector<uint8_t> listBytes(bytes.begin(),
+                                         bytes.begin() + static_cast<std::ptrdiff_t>(noOfListBytes));
+
+    fmt::print("{} bytes\n", toString(distribution));
+    encodeWithList("DoubleLinkedList encode", listBytes);
+    encodeBytes("ByteEncoder", bytes);
+    decodeBytes("ByteDecoder", bytes);
+    encodeAlphabet("AlphabetEncoder 256", makeInput<uint32_t>(noOfBytes / 4, 256, distribution), 256);
+    encodeAlphabet("AlphabetEncoder 65536", makeInput<uint32_t>(noOfBytes / 4, 65'536, distribution),
+                   65'536);
+  }
+  return 0;
+}
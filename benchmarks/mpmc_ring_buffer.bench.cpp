@@ -0,0 +1,92 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint64_t;
+
+// noOfProducers threads push noOfItems in total, noOfConsumers threads drain them.
+void run(std::size_t noOfProducers, std::size_t noOfConsumers, std::size_t noOfItems,
+         std::size_t capacity)
+{
+  ch1::cyclic_buffer::MpmcRingBuffer<Item> ringBuffer{capacity};
+  const std::size_t itemsPerProducer{noOfItems / noOfProducers};
+  const std::size_t totalItems{itemsPerProducer * noOfProducers};
+  std::atomic<std::size_t> noOfReceived{};
+
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        std::vector<std::thread> threads;
+        for (std::size_t p{}; p < noOfProducers; ++p)
+        {
+          threads.emplace_back(
+              [&]
+              {
+                for (Item i{}; i < itemsPerProducer; ++i)
+                {
+                  while (!ringBuffer.enqueue(i))
+                  {
+                    std::this_thread::yield();
+                  }
+                }
+              });
+        }
+        for (std::size_t c{}; c < noOfConsumers; ++c)
+        {
+          threads.emplace_back(
+              [&]
+              {
+                Item checksum{};
+                while (noOfReceived.load(std::memory_order_relaxed) < totalItems)
+                {
+                  if (const auto item{ringBuffer.dequeue()})
+                  {
+                    checksum += *item;
+                    noOfReceived.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                  }
+                  std::this_thread::yield();
+                }
+                bench::doNotOptimize(checksum);
+              });
+        }
+        for (auto& thread : threads)
+        {
+          thread.join();
+        }
+      })};
+
+  bench::report(fmt::format("MpmcRingBuffer {}P x {}C", noOfProducers, noOfConsumers), totalItems,
+                seconds);
+}
+}  // namespace
+
+// Usage: mpmc_ring_buffer_bench [noOfItems] [maxThreads] [capacity]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 4'000'000)};
+  const auto maxThreads{bench::argOr(argc, argv, 2, std::max(2U, std::thread::hardware_concurrency()))};
+  const auto capacity{bench::argOr(argc, argv, 3, 1024)};
+
+  fmt::print("Scaling producers and consumers up to {} threads each, {} items, capacity {}\n",
+             maxThreads, noOfItems, capacity);
+  for (std::size_t producers{1}; producers <= maxThreads; producers *= 2)
+  {
+    for (std::size_t consumers{1}; consumers <= maxThreads; consumers *= 2)
+    {
+      run(producers, consumers, noOfItems, capacity);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,130 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint64_t;
+using ch1::it::HeapNodeAllocator;
+using ch1::it::PoolNodeAllocator;
+using ch1::trace::NoTrace;
+
+// Keeps workingSet items alive, every op allocates one node and frees another.
+template <template <typename> typename NodeAllocator>
+void queueChurn(std::string_view allocatorName, std::size_t noOfOps, std::size_t workingSet)
+{
+  ch1::queue::QueueImpl<Item, NoTrace, NodeAllocator> queue;
+  for (Item i{}; i < workingSet; ++i)
+  {
+    queue.enqueue(i);
+  }
+
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        Item checksum{};
+        for (Item i{}; i < noOfOps; ++i)
+        {
+          queue.enqueue(i);
+          checksum += queue.dequeue();
+        }
+        bench::doNotOptimize(checksum);
+      })};
+  bench::report(fmt::format("QueueImpl enqueue+dequeue, {}", allocatorName), noOfOps, seconds);
+}
+
+template <template <typename> typename NodeAllocator>
+void listChurn(std::string_view allocatorName, std::size_t noOfOps, std::size_t workingSet)
+{
+  ch1::double_linked_list::DoubleLinkedList<Item, NoTrace, NodeAllocator> list;
+  for (Item i{}; i < workingSet; ++i)
+  {
+    list.pushRight(i);
+  }
+
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        for (Item i{}; i < noOfOps; ++i)
+        {
+          list.pushRight(i);
+          list.deleteFront();
+        }
+        bench::doNotOptimize(list);
+      })};
+  bench::report(fmt::format("DoubleLinkedList pushRight+deleteFront, {}", allocatorName), noOfOps,
+                seconds);
+}
+
+template <template <typename> typename NodeAllocator>
+void stackChurn(std::string_view allocatorName, std::size_t noOfOps, std::size_t burstSize)
+{
+  ch1::linked_list_stack::Stack<Item, NoTrace, NodeAllocator> stack;
+
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        Item checksum{};
+        for (std::size_t done{}; done < noOfOps; done += burstSize)
+        {
+          for (Item i{}; i < burstSize; ++i)
+          {
+            stack.push(i);
+          }
+          for (Item i{}; i < burstSize; ++i)
+          {
+            checksum += stack.pop();
+          }
+        }
+        bench::doNotOptimize(checksum);
+      })};
+  bench::report(fmt::format("Stack push/pop bursts of {}, {}", burstSize, allocatorName), noOfOps,
+                seconds);
+}
+
+// Fill and clear() repeatedly, pool releases whole slabs instead of freeing node by node.
+template <template <typename> typename NodeAllocator>
+void fillAndClear(std::string_view allocatorName, std::size_t noOfOps, std::size_t fillSize)
+{
+  ch1::queue::QueueImpl<Item, NoTrace, NodeAllocator> queue;
+
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t done{}; done < noOfOps; done += fillSize)
+        {
+          for (Item i{}; i < fillSize; ++i)
+          {
+            queue.enqueue(i);
+          }
+          queue.clear();
+        }
+      })};
+  bench::report(fmt::format("QueueImpl fill {} + clear, {}", fillSize, allocatorName), noOfOps, seconds);
+}
+}  // namespace
+
+// Usage: node_pool_bench [noOfOps] [workingSet]
+int main(int argc, char** argv)
+{
+  const auto noOfOps{bench::argOr(argc, argv, 1, 10'000'000)};
+  const auto workingSet{bench::argOr(argc, argv, 2, 100'000)};
+
+  fmt::print("Node allocation cost, {} ops, working set {}\n", noOfOps, workingSet);
+  queueChurn<HeapNodeAllocator>("new/delete", noOfOps, workingSet);
+  queueChurn<PoolNodeAllocator>("node pool", noOfOps, workingSet);
+  listChurn<HeapNodeAllocator>("new/delete", noOfOps, workingSet);
+  listChurn<PoolNodeAllocator>("node pool", noOfOps, workingSet);
+  stackChurn<HeapNodeAllocator>("new/delete", noOfOps, 1024);
+  stackChurn<PoolNodeAllocator>("node pool", noOfOps, 1024);
+  fillAndClear<HeapNodeAllocator>("new/delete", noOfOps, workingSet);
+  fillAndClear<PoolNodeAllocator>("node pool", noOfOps, workingSet);
+  return 0;
+}
@@ -0,0 +1,65 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint64_t;
+using ch1::queue::AnyQueue;
+using LinkedQueue = ch1::queue::QueueImpl<Item, ch1::trace::NoTrace, ch1::it::PoolNodeAllocator>;
+using RingQueue = ch1::queue::RingQueue<Item>;
+
+// Keeps queue at depth items and rotates it, so every op is an enqueue or a dequeue.
+// Same code for every queue; statically dispatched unless queue is AnyQueue.
+void rotate(std::string_view name, ch1::queue::FifoQueue auto& queue, std::size_t depth,
+            std::size_t noOfOps)
+{
+  for (Item i{}; i < depth; ++i)
+  {
+    queue.enqueue(i);
+  }
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t i{}; i < noOfOps / 2; ++i)
+        {
+          queue.enqueue(queue.dequeue() + 1);
+        }
+      })};
+  bench::doNotOptimize(queue.size());
+  bench::report(name, noOfOps, seconds);
+}
+}  // namespace
+
+// Usage: queue_dispatch_bench [noOfOps] [depth]
+int main(int argc, char** argv)
+{
+  const auto noOfOps{bench::argOr(argc, argv, 1, 40'000'000)};
+  const auto depth{bench::argOr(argc, argv, 2, 64)};
+
+  fmt::print("Static (FifoQueue) vs virtual (AnyQueue) calls, queue depth {}\n", depth);
+  {
+    LinkedQueue queue;
+    rotate("QueueImpl pool, static", queue, depth, noOfOps);
+  }
+  {
+    AnyQueue<Item> queue{std::in_place_type<LinkedQueue>};
+    rotate("QueueImpl pool, AnyQueue", queue, depth, noOfOps);
+  }
+  {
+    RingQueue queue;
+    rotate("RingQueue, static", queue, depth, noOfOps);
+  }
+  {
+    AnyQueue<Item> queue{std::in_place_type<RingQueue>};
+    rotate("RingQueue, AnyQueue", queue, depth, noOfOps);
+  }
+  return 0;
+}
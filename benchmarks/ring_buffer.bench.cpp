@@ -0,0 +1,170 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint64_t;
+
+// Producer and consumer threads hand off noOfItems through the queue.
+// tryEnqueue/tryDequeue are retried (with yield) until they succeed.
+template <typename TryEnqueue, typename TryDequeue>
+double handOff(std::size_t noOfItems, TryEnqueue tryEnqueue, TryDequeue tryDequeue)
+{
+  return bench::measureSeconds(
+      [&]
+      {
+        std::thread producer{[&]
+                             {
+                               for (Item i{}; i < noOfItems; ++i)
+                               {
+                                 while (!tryEnqueue(i))
+                                 {
+                                   std::this_thread::yield();
+                                 }
+                               }
+                             }};
+
+        Item checksum{};
+        for (std::size_t received{}; received < noOfItems;)
+        {
+          if (const auto item{tryDequeue()})
+          {
+            checksum += *item;
+            ++received;
+            continue;
+          }
+          std::this_thread::yield();
+        }
+        producer.join();
+        bench::doNotOptimize(checksum);
+      });
+}
+
+template <typename Ring>
+void spscRingBuffer(std::string_view name, std::size_t noOfItems, std::size_t capacity)
+{
+  Ring ringBuffer{capacity};
+
+  const auto seconds{handOff(
+      noOfItems, [&](Item item) { return ringBuffer.enqueue(item); },
+      [&] { return ringBuffer.dequeue(); })};
+  bench::report(name, noOfItems, seconds);
+}
+
+void mutexRingBuffer(std::size_t noOfItems, std::size_t capacity)
+{
+  ch1::cyclic_buffer::RingBuffer<Item> ringBuffer{capacity};
+  std::mutex mutex;
+
+  const auto seconds{handOff(
+      noOfItems,
+      [&](Item item)
+      {
+        const std::scoped_lock lock{mutex};
+        return ringBuffer.enqueue(item);
+      },
+      [&]
+      {
+        const std::scoped_lock lock{mutex};
+        return ringBuffer.dequeue();
+      })};
+  bench::report("RingBuffer + std::mutex", noOfItems, seconds);
+}
+
+// Single thread pushes and pops noOfItems in batches, element by element or with bulk calls.
+void batchTransfer(std::size_t noOfItems, std::size_t batchSize)
+{
+  ch1::cyclic_buffer::RingBuffer<Item> ringBuffer{batchSize};
+  std::vector<Item> batch(batchSize, 1);
+  const std::size_t noOfBatches{noOfItems / batchSize};
+
+  const auto perElementSeconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t b{}; b < noOfBatches; ++b)
+        {
+          for (const auto item : batch)
+          {
+            ringBuffer.enqueue(item);
+          }
+          for (auto& item : batch)
+          {
+            item = *ringBuffer.dequeue();
+          }
+        }
+        bench::doNotOptimize(batch);
+      })};
+  bench::report(fmt::format("RingBuffer enqueue/dequeue, batch {}", batchSize), noOfBatches * batchSize,
+                perElementSeconds);
+
+  const auto bulkSeconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t b{}; b < noOfBatches; ++b)
+        {
+          ringBuffer.enqueueBulk(batch);
+          ringBuffer.dequeueBulk(batch);
+        }
+        bench::doNotOptimize(batch);
+      })};
+  bench::report(fmt::format("RingBuffer enqueueBulk/dequeueBulk, batch {}", batchSize),
+                noOfBatches * batchSize, bulkSeconds);
+}
+
+// Single thread keeps a ring half full while enqueueing and dequeueing noOfItems.
+template <typename Ring>
+void steadyState(std::string_view name, Ring& ringBuffer, std::size_t noOfItems)
+{
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        Item checksum{};
+        for (Item i{}; i < noOfItems; ++i)
+        {
+          ringBuffer.enqueue(i);
+          if (ringBuffer.size() * 2 >= ringBuffer.capacity())
+          {
+            checksum += *ringBuffer.dequeue();
+          }
+        }
+        bench::doNotOptimize(checksum);
+      })};
+  bench::report(name, noOfItems, seconds);
+}
+}  // namespace
+
+// Usage: ring_buffer_bench [noOfItems] [capacity]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 10'000'000)};
+  const auto capacity{bench::argOr(argc, argv, 2, 1024)};
+
+  fmt::print("Producer -> consumer hand-off, {} items, capacity {}\n", noOfItems, capacity);
+  using ch1::cyclic_buffer::BlockingSpscRingBuffer;
+  using ch1::cyclic_buffer::SpscRingBuffer;
+  spscRingBuffer<SpscRingBuffer<Item>>("SpscRingBuffer (lock-free)", noOfItems, capacity);
+  spscRingBuffer<BlockingSpscRingBuffer<Item>>("BlockingSpscRingBuffer (fence per enqueue)", noOfItems,
+                                               capacity);
+  mutexRingBuffer(noOfItems, capacity);
+
+  fmt::print("Single thread batch transfer, {} items\n", noOfItems);
+  batchTransfer(noOfItems, 4096);
+
+  constexpr std::size_t staticCapacity{1024};
+  fmt::print("Single thread steady state, {} items, capacity {}\n", noOfItems, staticCapacity);
+  ch1::cyclic_buffer::RingBuffer<Item> ringBuffer{staticCapacity};
+  steadyState("RingBuffer (heap, modulo)", ringBuffer, noOfItems);
+  ch1::cyclic_buffer::StaticRingBuffer<Item, staticCapacity> staticRingBuffer;
+  steadyState("StaticRingBuffer (inline, mask)", staticRingBuffer, noOfItems);
+  return 0;
+}
@@ -0,0 +1,88 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <cstdint>
+#include <deque>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint64_t;
+
+struct DequeAdapter
+{
+  void enqueue(Item item) { deque.push_back(item); }
+  Item dequeue()
+  {
+    const Item item{deque.front()};
+    deque.pop_front();
+    return item;
+  }
+
+  std::deque<Item> deque;
+};
+
+// Each round enqueues burstSize items and dequeues all but a few, so queue keeps growing slowly
+// and every burst crosses node/block/ring boundaries. Finally the queue is drained.
+template <typename Queue>
+void interleavedBursts(std::string_view name, Queue& queue, std::size_t noOfItems, std::size_t burstSize)
+{
+  const std::size_t noOfRounds{noOfItems / burstSize};
+  const std::size_t kept{burstSize / 8};
+
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        Item checksum{};
+        std::size_t queued{};
+        for (std::size_t round{}; round < noOfRounds; ++round)
+        {
+          for (std::size_t i{}; i < burstSize; ++i)
+          {
+            queue.enqueue(i);
+          }
+          for (std::size_t i{}; i < burstSize - kept; ++i)
+          {
+            checksum += queue.dequeue();
+          }
+          queued += kept;
+        }
+        for (; queued > 0; --queued)
+        {
+          checksum += queue.dequeue();
+        }
+        bench::doNotOptimize(checksum);
+      })};
+  bench::report(name, 2 * noOfRounds * burstSize, seconds);
+}
+}  // namespace
+
+// Usage: ring_queue_bench [noOfItems] [burstSize]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 10'000'000)};
+  const auto burstSize{bench::argOr(argc, argv, 2, 1024)};
+
+  fmt::print("Interleaved enqueue/dequeue bursts, {} items, burst {}\n", noOfItems, burstSize);
+  {
+    ch1::queue::QueueImpl<Item> queue;
+    interleavedBursts("QueueImpl (node per item)", queue, noOfItems, burstSize);
+  }
+  {
+    DequeAdapter queue;
+    interleavedBursts("std::deque", queue, noOfItems, burstSize);
+  }
+  {
+    ch1::queue::RingQueue<Item> queue;
+    interleavedBursts("RingQueue (grow only)", queue, noOfItems, burstSize);
+  }
+  {
+    ch1::queue::RingQueue<Item> queue{0, true};
+    interleavedBursts("RingQueue (shrink when sparse)", queue, noOfItems, burstSize);
+  }
+  return 0;
+}
@@ -0,0 +1,133 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint64_t;
+
+// Runs consumer in a forked child process and producer in this one.
+// Measured time ends when the child has received every item and exited.
+template <typename Producer, typename Consumer>
+double acrossProcesses(Producer producer, Consumer consumer)
+{
+  return bench::measureSeconds(
+      [&]
+      {
+        const pid_t child{fork()};
+        if (child == -1)
+        {
+          std::perror("fork");
+          std::exit(EXIT_FAILURE);
+        }
+        if (child == 0)
+        {
+          _exit(consumer() ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        producer();
+        int status{};
+        waitpid(child, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+        {
+          fmt::print("Consumer process failed\n");
+        }
+      });
+}
+
+void sharedMemoryRingBuffer(std::size_t noOfItems, std::size_t capacity)
+{
+  const std::string name{"/ch1_bench_ring_" + std::to_string(getpid())};
+  auto producerRing{ch1::cyclic_buffer::SharedMemoryRingBuffer<Item>::create(name, capacity)};
+
+  const auto seconds{acrossProcesses(
+      [&]
+      {
+        for (Item i{}; i < noOfItems; ++i)
+        {
+          while (!producerRing.enqueue(i))
+          {
+            std::this_thread::yield();
+          }
+        }
+      },
+      [&]
+      {
+        auto consumerRing{ch1::cyclic_buffer::SharedMemoryRingBuffer<Item>::open(name)};
+        for (Item expected{}; expected < noOfItems;)
+        {
+          if (const auto item{consumerRing.dequeue()})
+          {
+            if (*item != expected++)
+            {
+              return false;
+            }
+            continue;
+          }
+          std::this_thread::yield();
+        }
+        return true;
+      })};
+  bench::report("SharedMemoryRingBuffer (no syscalls)", noOfItems, seconds);
+}
+
+void pipeBaseline(std::size_t noOfItems)
+{
+  int fds[2]{};
+  if (pipe(fds) == -1)
+  {
+    std::perror("pipe");
+    return;
+  }
+
+  const auto seconds{acrossProcesses(
+      [&]
+      {
+        close(fds[0]);
+        for (Item i{}; i < noOfItems; ++i)
+        {
+          if (write(fds[1], &i, sizeof(i)) != sizeof(i))
+          {
+            break;
+          }
+        }
+        close(fds[1]);
+      },
+      [&]
+      {
+        close(fds[1]);
+        Item item{};
+        for (Item expected{}; expected < noOfItems; ++expected)
+        {
+          if (read(fds[0], &item, sizeof(item)) != sizeof(item) || item != expected)
+          {
+            return false;
+          }
+        }
+        return true;
+      })};
+  bench::report("pipe, one write/read per item", noOfItems, seconds);
+}
+}  // namespace
+
+// Usage: shared_memory_ring_buffer_bench [noOfItems] [capacity]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 10'000'000)};
+  const auto capacity{bench::argOr(argc, argv, 2, 4096)};
+
+  fmt::print("Producer process -> consumer process, {} items, capacity {}\n", noOfItems, capacity);
+  sharedMemoryRingBuffer(noOfItems, capacity);
+  pipeBaseline(noOfItems);
+  return 0;
+}
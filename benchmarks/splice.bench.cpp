@@ -0,0 +1,110 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <cstdint>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint64_t;
+using Queue = ch1::queue::QueueImpl<Item>;
+using List = ch1::double_linked_list::DoubleLinkedList<Item>;
+
+// Front batches of batchSize items move between two containers holding 4 batches, noOfItems items moved
+// in total.
+void queueBatches(std::size_t noOfItems, std::size_t batchSize)
+{
+  Queue from;
+  Queue to;
+  for (Item i{}; i < 4 * batchSize; ++i)
+  {
+    from.enqueue(i);
+  }
+  const std::size_t noOfBatches{noOfItems / batchSize};
+
+  const auto perItemSeconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t b{}; b < noOfBatches; ++b)
+        {
+          auto& source{b % 2 == 0 ? from : to};
+          auto& destination{b % 2 == 0 ? to : from};
+          for (std::size_t i{}; i < batchSize; ++i)
+          {
+            destination.enqueue(source.dequeue());
+          }
+        }
+      })};
+  bench::report(fmt::format("QueueImpl dequeue+enqueue, batch {}", batchSize), noOfBatches * batchSize,
+                perItemSeconds);
+
+  const auto spliceSeconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t b{}; b < noOfBatches; ++b)
+        {
+          auto& source{b % 2 == 0 ? from : to};
+          auto& destination{b % 2 == 0 ? to : from};
+          source.moveFrontTo(destination, batchSize);
+        }
+      })};
+  bench::report(fmt::format("QueueImpl moveFrontTo, batch {}", batchSize), noOfBatches * batchSize,
+                spliceSeconds);
+}
+
+void listBatches(std::size_t noOfItems, std::size_t batchSize)
+{
+  List from;
+  List to;
+  for (Item i{}; i < 4 * batchSize; ++i)
+  {
+    from.pushRight(i);
+  }
+  const std::size_t noOfBatches{noOfItems / batchSize};
+
+  const auto perItemSeconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t b{}; b < noOfBatches; ++b)
+        {
+          auto& source{b % 2 == 0 ? from : to};
+          auto& destination{b % 2 == 0 ? to : from};
+          for (std::size_t i{}; i < batchSize; ++i)
+          {
+            destination.pushRight(*source.front());
+            source.deleteFront();
+          }
+        }
+      })};
+  bench::report(fmt::format("DoubleLinkedList deleteFront+pushRight, batch {}", batchSize),
+                noOfBatches * batchSize, perItemSeconds);
+
+  const auto spliceSeconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t b{}; b < noOfBatches; ++b)
+        {
+          auto& source{b % 2 == 0 ? from : to};
+          auto& destination{b % 2 == 0 ? to : from};
+          destination.splice(destination.end(), source, source.begin(), source.begin() + batchSize);
+        }
+      })};
+  bench::report(fmt::format("DoubleLinkedList range splice, batch {}", batchSize),
+                noOfBatches * batchSize, spliceSeconds);
+}
+}  // namespace
+
+// Usage: splice_bench [noOfItems] [batchSize]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 10'000'000)};
+  const auto batchSize{bench::argOr(argc, argv, 2, 1024)};
+
+  fmt::print("Moving batches between containers, {} items\n", noOfItems);
+  queueBatches(noOfItems, batchSize);
+  listBatches(noOfItems, batchSize);
+  return 0;
+}
@@ -0,0 +1,78 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = int32_t;
+
+template <typename List>
+void fill(List& list, std::size_t noOfItems)
+{
+  for (std::size_t i{}; i < noOfItems; ++i)
+  {
+    list.pushRight(static_cast<Item>(i));
+  }
+}
+
+void iterate(std::string_view name, auto& list, std::size_t noOfItems, std::size_t noOfRounds,
+             auto itemOf)
+{
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        int64_t checksum{};
+        for (std::size_t round{}; round < noOfRounds; ++round)
+        {
+          std::for_each(list.begin(), list.end(),
+                        [&](const auto& element) { checksum += itemOf(element); });
+        }
+        bench::doNotOptimize(checksum);
+      })};
+  bench::report(name, noOfItems * noOfRounds, seconds);
+}
+
+// Every search looks for the last item, so whole list is scanned.
+void search(std::string_view name, auto& list, std::size_t noOfItems, std::size_t noOfSearches)
+{
+  const auto needle{static_cast<Item>(noOfItems - 1)};
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        for (std::size_t i{}; i < noOfSearches; ++i)
+        {
+          bench::doNotOptimize(list.find(needle));
+        }
+      })};
+  bench::report(name, noOfItems * noOfSearches, seconds);
+}
+}  // namespace
+
+// Usage: unrolled_list_bench [noOfItems] [noOfRounds]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 1'000'000)};
+  const auto noOfRounds{bench::argOr(argc, argv, 2, 20)};
+
+  ch1::double_linked_list::DoubleLinkedList<Item> list;
+  fill(list, noOfItems);
+  ch1::double_linked_list::UnrolledLinkedList<Item> unrolledList;
+  fill(unrolledList, noOfItems);
+
+  fmt::print("Iteration, {} items x {} rounds (ops = items visited)\n", noOfItems, noOfRounds);
+  iterate("DoubleLinkedList", list, noOfItems, noOfRounds, [](const auto& node) { return node.item; });
+  iterate("UnrolledLinkedList", unrolledList, noOfItems, noOfRounds, [](Item item) { return item; });
+
+  fmt::print("Search for last item, {} items x {} searches (ops = items compared)\n", noOfItems,
+             noOfRounds);
+  search("DoubleLinkedList (node by node)", list, noOfItems, noOfRounds);
+  search("UnrolledLinkedList (SIMD per chunk)", unrolledList, noOfItems, noOfRounds);
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Nanoseconds = std::chrono::nanoseconds;
+
+int64_t nowNs()
+{
+  return std::chrono::duration_cast<Nanoseconds>(bench::Clock::now().time_since_epoch()).count();
+}
+
+double threadCpuSeconds()
+{
+  timespec time{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) / 1e9;
+}
+
+// Producer sends a timestamp every interval, consumer blocks in dequeueWait<WaitStrategy>().
+// Reports latency between enqueue and wake-up of the consumer, and consumer CPU use while waiting.
+template <typename WaitStrategy>
+void wakeUpLatency(std::string_view name, std::size_t noOfItems, std::chrono::microseconds interval)
+{
+  ch1::cyclic_buffer::BlockingSpscRingBuffer<int64_t> ringBuffer{64};
+  std::vector<int64_t> latencies;
+  latencies.reserve(noOfItems);
+
+  std::thread producer{[&]
+                       {
+                         for (std::size_t i{}; i < noOfItems; ++i)
+                         {
+                           std::this_thread::sleep_for(interval);
+                           ringBuffer.enqueue(nowNs());
+                         }
+                       }};
+
+  const auto wallStart{bench::Clock::now()};
+  const auto cpuStart{threadCpuSeconds()};
+  for (std::size_t i{}; i < noOfItems; ++i)
+  {
+    const auto sentNs{ringBuffer.dequeueWait<WaitStrategy>()};
+    latencies.push_back(nowNs() - sentNs);
+  }
+  const auto cpuSeconds{threadCpuSeconds() - cpuStart};
+  const auto wallSeconds{std::chrono::duration<double>(bench::Clock::now() - wallStart).count()};
+  producer.join();
+
+  std::ranges::sort(latencies);
+  const auto percentile{[&latencies](double p)
+                        {
+                          const auto last{static_cast<double>(latencies.size() - 1)};
+                          const auto index{static_cast<std::size_t>(p * last)};
+                          return static_cast<double>(latencies[index]) / 1e3;
+                        }};
+  fmt::print("{:<16} p50 {:>9.2f} us  p99 {:>9.2f} us  max {:>9.2f} us  consumer CPU {:>6.1f}%\n", name,
+             percentile(0.5), percentile(0.99), percentile(1.0), 100.0 * cpuSeconds / wallSeconds);
+}
+}  // namespace
+
+// Usage: wait_strategies_bench [noOfItems] [intervalUs]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 2'000)};
+  const std::chrono::microseconds interval{bench::argOr(argc, argv, 2, 100)};
+
+  fmt::print("Wake-up latency, {} items sent every {} us\n", noOfItems, interval.count());
+  wakeUpLatency<ch1::wait::BusySpin>("BusySpin", noOfItems, interval);
+  wakeUpLatency<ch1::wait::Yield>("Yield", noOfItems, interval);
+  wakeUpLatency<ch1::wait::SpinThenPark>("SpinThenPark", noOfItems, interval);
+  wakeUpLatency<ch1::wait::Park>("Park (futex)", noOfItems, interval);
+  return 0;
+}
@@ -0,0 +1,120 @@
+// Copyright [2024] <@damianWu>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "ch1/ch1.hpp"
+
+namespace
+{
+using Item = uint64_t;
+
+// Owner pushes noOfItems and pops every popEvery-th itself, noOfThieves threads steal the rest.
+void run(std::size_t noOfThieves, std::size_t noOfItems, std::size_t popEvery)
+{
+  ch1::double_linked_list::WorkStealingDeque<Item> deque;
+  std::atomic<std::size_t> noOfTaken{};
+  std::atomic<std::size_t> noOfStolen{};
+
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        std::vector<std::thread> thieves;
+        for (std::size_t t{}; t < noOfThieves; ++t)
+        {
+          thieves.emplace_back(
+              [&]
+              {
+                Item checksum{};
+                std::size_t stolen{};
+                while (noOfTaken.load(std::memory_order_relaxed) < noOfItems)
+                {
+                  if (const auto item{deque.stealLeft()})
+                  {
+                    checksum += *item;
+                    ++stolen;
+                    noOfTaken.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                  }
+                  std::this_thread::yield();
+                }
+                noOfStolen.fetch_add(stolen, std::memory_order_relaxed);
+                bench::doNotOptimize(checksum);
+              });
+        }
+
+        Item checksum{};
+        for (Item i{}; i < noOfItems; ++i)
+        {
+          deque.pushRight(i);
+          if (popEvery != 0 && i % popEvery == 0)
+          {
+            if (const auto item{deque.popRight()})
+            {
+              checksum += *item;
+              noOfTaken.fetch_add(1, std::memory_order_relaxed);
+            }
+          }
+        }
+        while (const auto item{deque.popRight()})
+        {
+          checksum += *item;
+          noOfTaken.fetch_add(1, std::memory_order_relaxed);
+        }
+        bench::doNotOptimize(checksum);
+        for (auto& thief : thieves)
+        {
+          thief.join();
+        }
+      })};
+
+  bench::report(fmt::format("WorkStealingDeque {} thieves, owner pops 1/{}", noOfThieves, popEvery),
+                noOfItems, seconds);
+  const auto stolen{static_cast<double>(noOfStolen.load())};
+  fmt::print("{:<56} {:>11.1f}% stolen, {:.2f} Msteals/s\n", "",
+             100.0 * stolen / static_cast<double>(noOfItems), stolen / seconds / 1e6);
+}
+
+// Owner only: push and pop without contention, the fast path of the deque.
+void runOwnerOnly(std::size_t noOfItems)
+{
+  ch1::double_linked_list::WorkStealingDeque<Item> deque;
+  Item checksum{};
+  const auto seconds{bench::measureSeconds(
+      [&]
+      {
+        for (Item i{}; i < noOfItems; ++i)
+        {
+          deque.pushRight(i);
+          deque.pushRight(i);
+          checksum += *deque.popRight();
+          checksum += *deque.popRight();
+        }
+      })};
+  bench::doNotOptimize(checksum);
+  bench::report("WorkStealingDeque owner push+pop", 4 * noOfItems, seconds);
+}
+}  // namespace
+
+// Usage: work_stealing_bench [noOfItems] [maxThieves] [popEvery]
+int main(int argc, char** argv)
+{
+  const auto noOfItems{bench::argOr(argc, argv, 1, 4'000'000)};
+  const auto maxThieves{
+      bench::argOr(argc, argv, 2, std::max(2U, std::thread::hardware_concurrency()) - 1)};
+  const auto popEvery{bench::argOr(argc, argv, 3, 4)};
+
+  fmt::print("Steal throughput up to {} thieves, {} items\n", maxThieves, noOfItems);
+  runOwnerOnly(noOfItems);
+  for (std::size_t thieves{1}; thieves <= maxThieves; thieves *= 2)
+  {
+    run(thieves, noOfItems, popEvery);
+  }
+  return 0;
+}
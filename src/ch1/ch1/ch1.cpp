@@ -2,13 +2,892 @@
 
 #include "ch1/ch1.hpp"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
 #include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <ctime>
 #include <cstdint>
 #include <iterator>
+#include <limits>
+#include <mutex>
+#include <numeric>
 #include <string>
+#include <system_error>
 
 namespace ch1
 {
+namespace trace
+{
+std::string_view toString(Event event)
+{
+  switch (event)
+  {
+    case Event::enqueue:
+      return "enqueue";
+    case Event::enqueueRejected:
+      return "enqueueRejected";
+    case Event::dequeue:
+      return "dequeue";
+    case Event::dequeueEmpty:
+      return "dequeueEmpty";
+    case Event::enqueueBulk:
+      return "enqueueBulk";
+    case Event::dequeueBulk:
+      return "dequeueBulk";
+    case Event::drop:
+      return "drop";
+    case Event::push:
+      return "push";
+    case Event::pop:
+      return "pop";
+    case Event::insert:
+      return "insert";
+    case Event::remove:
+      return "remove";
+    case Event::copy:
+      return "copy";
+    case Event::clear:
+      return "clear";
+    case Event::splice:
+      return "splice";
+  }
+  return "unknown";
+}
+
+TraceBuffer& TraceBuffer::instance()
+{
+  static TraceBuffer traceBuffer;
+  return traceBuffer;
+}
+
+size_t TraceBuffer::size() const
+{
+  return static_cast<size_t>(std::min<uint64_t>(noOfRecorded(), capacity));
+}
+
+uint64_t TraceBuffer::noOfRecorded() const
+{
+  return m_next.load(std::memory_order_acquire);
+}
+
+// Index 0 is the oldest record kept in the log
+const Record& TraceBuffer::operator[](size_t index) const
+{
+  const auto oldest{noOfRecorded() - size()};
+  return m_records[(oldest + index) % capacity];
+}
+
+void TraceBuffer::dump(std::ostream& ostream) const
+{
+  for (size_t i{}; i < size(); ++i)
+  {
+    const auto& record{(*this)[i]};
+    ostream << fmt::format("{} {} {}\n", record.timestampNs, record.container, toString(record.event));
+  }
+}
+
+void TraceBuffer::clear()
+{
+  m_next.store(0, std::memory_order_release);
+}
+}  // namespace trace
+
+namespace it
+{
+namespace
+{
+// Empty slabs kept by a thread for reuse, the rest goes back to the heap
+class SpareSlabs
+{
+public:
+  SpareSlabs() = default;
+  SpareSlabs(const SpareSlabs&) = delete;
+  SpareSlabs(SpareSlabs&&) = delete;
+  SpareSlabs& operator=(const SpareSlabs&) = delete;
+  SpareSlabs& operator=(SpareSlabs&&) = delete;
+  ~SpareSlabs()
+  {
+    for (size_t i{}; i < m_size; ++i)
+    {
+      ::operator delete(m_slabs[i]);
+    }
+  }
+
+  void* pop() { return m_size == 0 ? nullptr : m_slabs[--m_size]; }
+
+  bool push(void* slab)
+  {
+    if (m_size == m_slabs.size())
+    {
+      return false;
+    }
+    m_slabs[m_size++] = slab;
+    return true;
+  }
+
+private:
+  std::array<void*, 64> m_slabs{};
+  size_t m_size{};
+};
+
+thread_local SpareSlabs spareSlabs;
+}  // namespace
+
+void* acquireSlab()
+{
+  if (void* slab{spareSlabs.pop()}; slab != nullptr)
+  {
+    return slab;
+  }
+  return ::operator new(slabSize);
+}
+
+void releaseSlab(void* slab)
+{
+  if (!spareSlabs.push(slab))
+  {
+    ::operator delete(slab);
+  }
+}
+}  // namespace it
+
+namespace wait
+{
+void Notifier::park(uint32_t epoch, Deadline deadline)
+{
+#ifdef __linux__
+  timespec timeout{};
+  timespec* timeoutPtr{};
+  if (deadline.has_value())
+  {
+    const auto remaining{std::chrono::duration_cast<std::chrono::nanoseconds>(*deadline - Clock::now())};
+    if (remaining.count() <= 0)
+    {
+      return;
+    }
+    timeout.tv_sec = static_cast<time_t>(remaining.count() / 1'000'000'000);
+    timeout.tv_nsec = static_cast<long>(remaining.count() % 1'000'000'000);  // NOLINT(runtime/int)
+    timeoutPtr = &timeout;
+  }
+  // Returns at once when epoch already changed, spurious wake-ups are handled by the caller's loop
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch), FUTEX_WAIT_PRIVATE, epoch, timeoutPtr,
+          nullptr, 0);
+#else
+  if (!deadline.has_value())
+  {
+    m_epoch.wait(epoch, std::memory_order_acquire);
+    return;
+  }
+  std::this_thread::sleep_for(
+      std::min<Clock::duration>(*deadline - Clock::now(), std::chrono::milliseconds{1}));
+#endif
+}
+
+void Notifier::wakeAll()
+{
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr,
+          nullptr, 0);
+#else
+  m_epoch.notify_all();
+#endif
+}
+}  // namespace wait
+
+namespace hazard
+{
+namespace
+{
+std::atomic<Record*> records{};
+std::atomic<size_t> noOfRecords{};
+
+// Pointers retired by threads which exited while the pointers were still protected
+std::mutex orphansMutex;
+std::vector<std::pair<void*, Deleter>> orphans;
+std::atomic<bool> hasOrphans{};
+
+Record* acquireRecord()
+{
+  for (auto* record{records.load(std::memory_order_acquire)}; record != nullptr; record = record->next)
+  {
+    bool isActive{false};
+    if (!record->isActive.load(std::memory_order_relaxed) &&
+        record->isActive.compare_exchange_strong(isActive, true, std::memory_order_acquire))
+    {
+      return record;
+    }
+  }
+
+  auto* record{new Record{}};
+  record->isActive.store(true, std::memory_order_relaxed);
+  record->next = records.load(std::memory_order_relaxed);
+  while (!records.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                        std::memory_order_relaxed))
+  {
+  }
+  noOfRecords.fetch_add(1, std::memory_order_relaxed);
+  return record;
+}
+
+// Records and retired pointers of one thread, handed back on thread exit
+class ThreadState
+{
+public:
+  ThreadState() = default;
+  ThreadState(const ThreadState&) = delete;
+  ThreadState(ThreadState&&) = delete;
+  ThreadState& operator=(const ThreadState&) = delete;
+  ThreadState& operator=(ThreadState&&) = delete;
+
+  ~ThreadState()
+  {
+    for (auto* record : m_freeRecords)
+    {
+      record->isActive.store(false, std::memory_order_release);
+    }
+    if (reclaim() != 0)
+    {
+      const std::scoped_lock lock{orphansMutex};
+      orphans.insert(orphans.end(), m_retired.begin(), m_retired.end());
+      hasOrphans.store(true, std::memory_order_release);
+    }
+  }
+
+  Record* acquire()
+  {
+    if (m_freeRecords.empty())
+    {
+      return acquireRecord();
+    }
+    auto* record{m_freeRecords.back()};
+    m_freeRecords.pop_back();
+    return record;
+  }
+
+  void release(Record* record) { m_freeRecords.push_back(record); }
+
+  void retire(void* pointer, Deleter deleter)
+  {
+    m_retired.emplace_back(pointer, deleter);
+    // Amortised O(1) per retire: each scan frees at least half of the list
+    if (m_retired.size() >= 2 * noOfRecords.load(std::memory_order_relaxed) + 64)
+    {
+      reclaim();
+    }
+  }
+
+  size_t reclaim()
+  {
+    if (hasOrphans.load(std::memory_order_acquire))
+    {
+      const std::scoped_lock lock{orphansMutex};
+      m_retired.insert(m_retired.end(), orphans.begin(), orphans.end());
+      orphans.clear();
+      hasOrphans.store(false, std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_hazards.clear();
+    for (auto* record{records.load(std::memory_order_acquire)}; record != nullptr; record = record->next)
+    {
+      if (const auto* pointer{record->pointer.load(std::memory_order_seq_cst)}; pointer != nullptr)
+      {
+        m_hazards.push_back(pointer);
+      }
+    }
+    std::sort(m_hazards.begin(), m_hazards.end());
+
+    const auto isProtected{[this](const std::pair<void*, Deleter>& retired)
+                           {
+                             return std::binary_search(m_hazards.begin(), m_hazards.end(),
+                                                       retired.first);
+                           }};
+    const auto firstFree{std::partition(m_retired.begin(), m_retired.end(), isProtected)};
+    for (auto it{firstFree}; it != m_retired.end(); ++it)
+    {
+      it->second(it->first);
+    }
+    m_retired.erase(firstFree, m_retired.end());
+    return m_retired.size();
+  }
+
+private:
+  std::vector<Record*> m_freeRecords;
+  std::vector<std::pair<void*, Deleter>> m_retired;
+  // Scratch space of reclaim(), kept to avoid allocating on every scan
+  std::vector<const void*> m_hazards;
+};
+
+thread_local ThreadState threadState;
+}  // namespace
+
+HazardPointer::HazardPointer() : m_record{threadState.acquire()} {}
+
+HazardPointer::~HazardPointer()
+{
+  reset();
+  threadState.release(m_record);
+}
+
+void retire(void* pointer, Deleter deleter)
+{
+  threadState.retire(pointer, deleter);
+}
+
+size_t reclaim()
+{
+  return threadState.reclaim();
+}
+}  // namespace hazard
+
+namespace cyclic_buffer
+{
+SharedMemory::SharedMemory(std::string name, std::byte* data, size_t size, bool isOwner)
+    : m_name{std::move(name)}, m_data{data}, m_size{size}, m_isOwner{isOwner}
+{
+}
+
+SharedMemory SharedMemory::create(const std::string& name, size_t size)
+{
+  const int fd{shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR)};
+  if (fd == -1)
+  {
+    throw std::system_error(errno, std::generic_category(), "shm_open(" + name + ")");
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(size)) == -1)
+  {
+    const int error{errno};
+    close(fd);
+    shm_unlink(name.c_str());
+    throw std::system_error(error, std::generic_category(), "ftruncate(" + name + ")");
+  }
+
+  void* const data{mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)};
+  const int error{errno};
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    shm_unlink(name.c_str());
+    throw std::system_error(error, std::generic_category(), "mmap(" + name + ")");
+  }
+  return SharedMemory{name, static_cast<std::byte*>(data), size, true};
+}
+
+SharedMemory SharedMemory::open(const std::string& name)
+{
+  const int fd{shm_open(name.c_str(), O_RDWR, 0)};
+  if (fd == -1)
+  {
+    throw std::system_error(errno, std::generic_category(), "shm_open(" + name + ")");
+  }
+
+  struct stat status{};
+  if (fstat(fd, &status) == -1)
+  {
+    const int error{errno};
+    close(fd);
+    throw std::system_error(error, std::generic_category(), "fstat(" + name + ")");
+  }
+
+  const auto size{static_cast<size_t>(status.st_size)};
+  void* const data{mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)};
+  const int error{errno};
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    throw std::system_error(error, std::generic_category(), "mmap(" + name + ")");
+  }
+  return SharedMemory{name, static_cast<std::byte*>(data), size, false};
+}
+
+SharedMemory::SharedMemory(SharedMemory&& rhs) noexcept
+    : m_name{std::move(rhs.m_name)},
+      m_data{std::exchange(rhs.m_data, nullptr)},
+      m_size{std::exchange(rhs.m_size, 0)},
+      m_isOwner{std::exchange(rhs.m_isOwner, false)}
+{
+}
+
+SharedMemory& SharedMemory::operator=(SharedMemory&& rhs) noexcept
+{
+  if (this != &rhs)
+  {
+    unmap();
+    m_name = std::move(rhs.m_name);
+    m_data = std::exchange(rhs.m_data, nullptr);
+    m_size = std::exchange(rhs.m_size, 0);
+    m_isOwner = std::exchange(rhs.m_isOwner, false);
+  }
+  return *this;
+}
+
+SharedMemory::~SharedMemory()
+{
+  unmap();
+}
+
+void SharedMemory::unmap()
+{
+  if (m_data == nullptr)
+  {
+    return;
+  }
+  munmap(m_data, m_size);
+  if (m_isOwner)
+  {
+    shm_unlink(m_name.c_str());
+  }
+  m_data = nullptr;
+}
+
+namespace
+{
+size_t mirroredCapacity(size_t capacity)
+{
+  const auto pageSize{static_cast<size_t>(sysconf(_SC_PAGESIZE))};
+  return std::bit_ceil(std::max(capacity, pageSize));
+}
+}  // namespace
+
+MirroredByteRingBuffer::MirroredByteRingBuffer(size_t capacity)
+    : m_capacity{mirroredCapacity(capacity)}, m_mask{m_capacity - 1}
+{
+  const int fd{memfd_create("ch1_mirrored_ring", MFD_CLOEXEC)};
+  if (fd == -1)
+  {
+    throw std::system_error(errno, std::generic_category(), "memfd_create");
+  }
+  if (ftruncate(fd, static_cast<off_t>(m_capacity)) == -1)
+  {
+    const int error{errno};
+    close(fd);
+    throw std::system_error(error, std::generic_category(), "ftruncate");
+  }
+
+  // Reserve address range for both copies, then map the same file into each half
+  void* const reserved{mmap(nullptr, 2 * m_capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+  if (reserved == MAP_FAILED)
+  {
+    const int error{errno};
+    close(fd);
+    throw std::system_error(error, std::generic_category(), "mmap");
+  }
+
+  auto* const data{static_cast<std::byte*>(reserved)};
+  for (auto* const half : {data, data + m_capacity})
+  {
+    if (mmap(half, m_capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+      const int error{errno};
+      munmap(reserved, 2 * m_capacity);
+      close(fd);
+      throw std::system_error(error, std::generic_category(), "mmap");
+    }
+  }
+
+  // Mappings keep the memory alive
+  close(fd);
+  m_data = data;
+}
+
+MirroredByteRingBuffer::~MirroredByteRingBuffer()
+{
+  munmap(m_data, 2 * m_capacity);
+}
+
+std::span<const std::byte> MirroredByteRingBuffer::readable() const
+{
+  return {m_data + (m_dequeueIndex & m_mask), size()};
+}
+
+void MirroredByteRingBuffer::consume(size_t count)
+{
+  m_dequeueIndex += std::min(count, size());
+}
+
+std::span<std::byte> MirroredByteRingBuffer::writable()
+{
+  return {m_data + (m_enqueueIndex & m_mask), m_capacity - size()};
+}
+
+void MirroredByteRingBuffer::commit(size_t count)
+{
+  m_enqueueIndex += std::min(count, m_capacity - size());
+}
+
+size_t MirroredByteRingBuffer::write(std::span<const std::byte> bytes)
+{
+  const auto destination{writable()};
+  const size_t count{std::min(bytes.size(), destination.size())};
+  std::copy_n(bytes.data(), count, destination.data());
+  commit(count);
+  return count;
+}
+
+size_t MirroredByteRingBuffer::read(std::span<std::byte> bytes)
+{
+  const auto source{readable()};
+  const size_t count{std::min(bytes.size(), source.size())};
+  std::copy_n(source.data(), count, bytes.data());
+  consume(count);
+  return count;
+}
+}  // namespace cyclic_buffer
+
+namespace move_to_front
+{
+namespace
+{
+constexpr size_t fileChunkSize{1U << 16U};
+constexpr uint32_t noSymbol{std::numeric_limits<uint32_t>::max()};
+
+// Closes descriptor on every path out of transformFile()
+struct FileDescriptor
+{
+  FileDescriptor(const std::string& path, int flags)
+      : fd{open(path.c_str(), flags, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)}
+  {
+    if (fd == -1)
+    {
+      throw std::system_error(errno, std::generic_category(), "open(" + path + ")");
+    }
+  }
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor(FileDescriptor&&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(FileDescriptor&&) = delete;
+  ~FileDescriptor() { close(fd); }
+
+  const int fd;
+};
+
+template <typename Transform>
+void transformFile(const std::string& inputPath, const std::string& outputPath, Transform transform)
+{
+  const FileDescriptor input{inputPath, O_RDONLY};
+  const FileDescriptor output{outputPath, O_WRONLY | O_CREAT | O_TRUNC};
+  std::vector<uint8_t> inputChunk(fileChunkSize);
+  std::vector<uint8_t> outputChunk(fileChunkSize);
+
+  for (;;)
+  {
+    const auto noOfRead{read(input.fd, inputChunk.data(), inputChunk.size())};
+    if (noOfRead == -1 && errno == EINTR)
+    {
+      continue;
+    }
+    if (noOfRead == -1)
+    {
+      throw std::system_error(errno, std::generic_category(), "read(" + inputPath + ")");
+    }
+    if (noOfRead == 0)
+    {
+      return;
+    }
+
+    const auto size{static_cast<size_t>(noOfRead)};
+    transform(std::span<const uint8_t>{inputChunk}.first(size), std::span<uint8_t>{outputChunk});
+    for (size_t written{}; written < size;)
+    {
+      const auto noOfWritten{write(output.fd, outputChunk.data() + written, size - written)};
+      if (noOfWritten == -1 && errno == EINTR)
+      {
+        continue;
+      }
+      if (noOfWritten == -1)
+      {
+        throw std::system_error(errno, std::generic_category(), "write(" + outputPath + ")");
+      }
+      written += static_cast<size_t>(noOfWritten);
+    }
+  }
+}
+
+// Timeline of 2 * alphabetSize slots has to be addressable with uint32_t
+size_t checkAlphabetSize(size_t alphabetSize)
+{
+  if (alphabetSize == 0 || alphabetSize > noSymbol / 2)
+  {
+    throw std::invalid_argument("RankList: alphabet size out of range");
+  }
+  return alphabetSize;
+}
+
+void checkOutputSize(size_t inputSize, size_t outputSize)
+{
+  if (outputSize < inputSize)
+  {
+    throw std::invalid_argument("move to front: output shorter than input");
+  }
+}
+}  // namespace
+
+ByteEncoder::ByteEncoder()
+{
+  reset();
+}
+
+void ByteEncoder::reset()
+{
+  std::iota(m_table.begin(), m_table.end(), uint8_t{});
+}
+
+size_t ByteEncoder::find(uint8_t byte) const
+{
+  size_t i{};
+#if __has_include(<experimental/simd>)
+  namespace stdx = std::experimental;
+  using Simd = stdx::native_simd<uint8_t>;
+  const Simd needle{byte};
+  for (; i + Simd::size() <= m_table.size(); i += Simd::size())
+  {
+    const Simd lane{&m_table[i], stdx::vector_aligned};
+    if (const auto equal{lane == needle}; stdx::any_of(equal))
+    {
+      return i + static_cast<size_t>(stdx::find_first_set(equal));
+    }
+  }
+#endif
+  for (; m_table[i] != byte; ++i)
+  {
+  }
+  return i;
+}
+
+void ByteEncoder::encode(std::span<const uint8_t> input, std::span<uint8_t> output)
+{
+  checkOutputSize(input.size(), output.size());
+  for (size_t i{}; i < input.size(); ++i)
+  {
+    const auto byte{input[i]};
+    // Repeated byte is the common case after BWT and alike, skip the search
+    if (m_table[0] == byte)
+    {
+      output[i] = 0;
+      continue;
+    }
+    const auto position{find(byte)};
+    std::memmove(&m_table[1], &m_table[0], position);
+    m_table[0] = byte;
+    output[i] = static_cast<uint8_t>(position);
+  }
+}
+
+ByteDecoder::ByteDecoder()
+{
+  reset();
+}
+
+void ByteDecoder::reset()
+{
+  std::iota(m_table.begin(), m_table.end(), uint8_t{});
+}
+
+void ByteDecoder::decode(std::span<const uint8_t> input, std::span<uint8_t> output)
+{
+  checkOutputSize(input.size(), output.size());
+  for (size_t i{}; i < input.size(); ++i)
+  {
+    const auto position{input[i]};
+    if (position == 0)
+    {
+      output[i] = m_table[0];
+      continue;
+    }
+    const auto byte{m_table[position]};
+    std::memmove(&m_table[1], &m_table[0], position);
+    m_table[0] = byte;
+    output[i] = byte;
+  }
+}
+
+void encodeFile(const std::string& inputPath, const std::string& outputPath)
+{
+  ByteEncoder encoder;
+  transformFile(inputPath, outputPath,
+                [&encoder](auto input, auto output) { encoder.encode(input, output); });
+}
+
+void decodeFile(const std::string& inputPath, const std::string& outputPath)
+{
+  ByteDecoder decoder;
+  transformFile(inputPath, outputPath,
+                [&decoder](auto input, auto output) { decoder.decode(input, output); });
+}
+
+RankList::RankList(size_t alphabetSize)
+    : m_alphabetSize{checkAlphabetSize(alphabetSize)},
+      m_noOfSlots{2 * alphabetSize},
+      m_slotOf(alphabetSize),
+      m_symbolIn(m_noOfSlots, noSymbol),
+      m_tree(m_noOfSlots + 1)
+{
+  reset();
+}
+
+size_t RankList::alphabetSize() const
+{
+  return m_alphabetSize;
+}
+
+void RankList::reset()
+{
+  std::ranges::fill(m_symbolIn, noSymbol);
+  m_front = m_noOfSlots - m_alphabetSize;
+  for (uint32_t symbol{}; symbol < m_alphabetSize; ++symbol)
+  {
+    m_slotOf[symbol] = static_cast<uint32_t>(m_front + symbol);
+    m_symbolIn[m_front + symbol] = symbol;
+  }
+  buildTree();
+}
+
+void RankList::renumber()
+{
+  // Pack symbols in current order at the end of the timeline, slots only move up so walk from the back
+  size_t slot{m_noOfSlots};
+  for (size_t i{m_noOfSlots}; i-- > m_front;)
+  {
+    if (const auto symbol{std::exchange(m_symbolIn[i], noSymbol)}; symbol != noSymbol)
+    {
+      m_symbolIn[--slot] = symbol;
+      m_slotOf[symbol] = static_cast<uint32_t>(slot);
+    }
+  }
+  m_front = slot;
+  buildTree();
+}
+
+void RankList::buildTree()
+{
+  // Linear Fenwick build: every node passes its count to its parent
+  std::ranges::fill(m_tree, 0);
+  for (size_t i{1}; i <= m_noOfSlots; ++i)
+  {
+    m_tree[i] += m_symbolIn[i - 1] != noSymbol ? 1U : 0U;
+    if (const auto parent{i + (i & (~i + 1))}; parent <= m_noOfSlots)
+    {
+      m_tree[parent] += m_tree[i];
+    }
+  }
+}
+
+void RankList::add(size_t slot, int32_t delta)
+{
+  for (size_t i{slot + 1}; i <= m_noOfSlots; i += i & (~i + 1))
+  {
+    m_tree[i] = static_cast<uint32_t>(static_cast<int64_t>(m_tree[i]) + delta);
+  }
+}
+
+uint32_t RankList::rankOf(uint32_t symbol) const
+{
+  if (symbol >= m_alphabetSize)
+  {
+    throw std::out_of_range("RankList: symbol outside of alphabet");
+  }
+  uint32_t rank{};
+  for (size_t i{m_slotOf[symbol]}; i > 0; i -= i & (~i + 1))
+  {
+    rank += m_tree[i];
+  }
+  return rank;
+}
+
+uint32_t RankList::symbolAt(uint32_t rank) const
+{
+  if (rank >= m_alphabetSize)
+  {
+    throw std::out_of_range("RankList: rank outside of alphabet");
+  }
+  // Descend the Fenwick tree to the last slot with at most rank occupied slots up to it
+  size_t slot{};
+  uint32_t remaining{rank + 1};
+  for (size_t step{std::bit_floor(m_noOfSlots)}; step != 0; step >>= 1U)
+  {
+    if (slot + step <= m_noOfSlots && m_tree[slot + step] < remaining)
+    {
+      slot += step;
+      remaining -= m_tree[slot];
+    }
+  }
+  return m_symbolIn[slot];
+}
+
+void RankList::moveToFront(uint32_t symbol)
+{
+  if (symbol >= m_alphabetSize)
+  {
+    throw std::out_of_range("RankList: symbol outside of alphabet");
+  }
+  if (m_slotOf[symbol] == m_front)
+  {
+    return;
+  }
+  if (m_front == 0)
+  {
+    renumber();
+  }
+  add(m_slotOf[symbol], -1);
+  m_symbolIn[m_slotOf[symbol]] = noSymbol;
+  --m_front;
+  m_slotOf[symbol] = static_cast<uint32_t>(m_front);
+  m_symbolIn[m_front] = symbol;
+  add(m_front, 1);
+}
+
+AlphabetEncoder::AlphabetEncoder(size_t alphabetSize) : m_list{alphabetSize} {}
+
+uint32_t AlphabetEncoder::encode(uint32_t symbol)
+{
+  const auto rank{m_list.rankOf(symbol)};
+  m_list.moveToFront(symbol);
+  return rank;
+}
+
+void AlphabetEncoder::encode(std::span<const uint32_t> input, std::span<uint32_t> output)
+{
+  checkOutputSize(input.size(), output.size());
+  std::ranges::transform(input, output.begin(), [this](const auto symbol) { return encode(symbol); });
+}
+
+void AlphabetEncoder::reset()
+{
+  m_list.reset();
+}
+
+AlphabetDecoder::AlphabetDecoder(size_t alphabetSize) : m_list{alphabetSize} {}
+
+uint32_t AlphabetDecoder::decode(uint32_t rank)
+{
+  const auto symbol{m_list.symbolAt(rank)};
+  m_list.moveToFront(symbol);
+  return symbol;
+}
+
+void AlphabetDecoder::decode(std::span<const uint32_t> input, std::span<uint32_t> output)
+{
+  checkOutputSize(input.size(), output.size());
+  std::ranges::transform(input, output.begin(), [this](const auto rank) { return decode(rank); });
+}
+
+void AlphabetDecoder::reset()
+{
+  m_list.reset();
+}
+}  // namespace move_to_front
+
 namespace homework
 {
 bool ex1_3_5(std::string_view input)
@@ -73,16 +952,12 @@ void ex1_3_37(int32_t n, int32_t m)
 // Move to front
 std::string ex1_3_40(const std::string& input)
 {
-  double_linked_list::DoubleLinkedList<char> list;
+  // Index makes move of seen symbol to the back O(1)
+  double_linked_list::IndexedDoubleLinkedList<char> list;
 
   for (const auto c : input)
   {
-    if (list.find(c) != std::nullopt)
-    {
-      list.remove(c);
-      list.pushRight(c);
-      continue;
-    }
+    list.remove(c);
     list.pushRight(c);
   }
 
@@ -5,22 +5,139 @@
 #include <fmt/core.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
 #include <optional>
 #include <random>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#endif
 
 namespace ch1
 {
 using size_t = std::size_t;
 
+// Members touched by different threads are aligned to this to avoid false sharing.
+inline constexpr size_t cacheLineSize{64};
+
+namespace trace
+{
+enum class Event : uint8_t
+{
+  enqueue,
+  enqueueRejected,
+  dequeue,
+  dequeueEmpty,
+  enqueueBulk,
+  dequeueBulk,
+  drop,
+  push,
+  pop,
+  insert,
+  remove,
+  copy,
+  clear,
+  splice,
+};
+
+[[nodiscard]] std::string_view toString(Event event);
+
+// Default tracing policy of every container, record() compiles to nothing.
+struct NoTrace
+{
+  static constexpr void record(const void* /*container*/, Event /*event*/) noexcept {}
+};
+
+struct Record
+{
+  uint64_t timestampNs{};
+  const void* container{};
+  Event event{};
+};
+
+// Fixed size in-memory event log shared by all threads.
+// Writers claim a slot with a single fetch_add, so recording is lock-free and never allocates.
+// Once the log wraps, the oldest records are overwritten. Two writers whose indices differ by a multiple
+// of capacity may then write the same slot at once: fields are stored atomically one by one, so such a
+// record may mix fields of both events. The log is meant for post-mortem inspection, not for accounting.
+// dump(), operator[] and clear() must be called when no thread records anymore (e.g. after a run).
+class TraceBuffer
+{
+public:
+  static constexpr size_t capacity{size_t{1} << 16};
+
+  static TraceBuffer& instance();
+
+  void record(const void* container, Event event) noexcept;
+
+  // Number of records kept in the log (at most capacity)
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] uint64_t noOfRecorded() const;
+  [[nodiscard]] const Record& operator[](size_t index) const;
+
+  void dump(std::ostream& ostream = std::cout) const;
+  void clear();
+
+private:
+  std::atomic<uint64_t> m_next{};
+  std::array<Record, capacity> m_records{};
+};
+
+inline void TraceBuffer::record(const void* container, Event event) noexcept
+{
+  const auto index{m_next.fetch_add(1, std::memory_order_relaxed)};
+  const auto now{std::chrono::steady_clock::now().time_since_epoch()};
+  const auto timestampNs{std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()};
+  // Field-wise atomic stores: slot shared with a writer one lap ahead may tear, but is never a data race
+  auto& slot{m_records[index % capacity]};
+  std::atomic_ref{slot.timestampNs}.store(static_cast<uint64_t>(timestampNs), std::memory_order_relaxed);
+  std::atomic_ref{slot.container}.store(container, std::memory_order_relaxed);
+  std::atomic_ref{slot.event}.store(event, std::memory_order_relaxed);
+}
+
+// Records events into TraceBuffer::instance()
+struct BufferTrace
+{
+  static void record(const void* container, Event event) noexcept
+  {
+    TraceBuffer::instance().record(container, event);
+  }
+};
+
+// Prints every event immediately (slow, meant for debugging)
+struct PrintTrace
+{
+  static void record(const void* container, Event event)
+  {
+    fmt::print("{} {}\n", container, toString(event));
+  }
+};
+}  // namespace trace
+
 namespace it
 {
 template <typename Item>
@@ -59,19 +176,28 @@ struct DoubleNode
   bool operator!=(const DoubleNode& second) { return !(*this == second); }
 };
 
+// Nodes linked both ways (DoubleNode, intrusive objects) make Iterator bidirectional
+template <typename NodeType>
+concept HasPrev = requires(NodeType node) { node.prev; };
+
 template <typename NodeType>
 struct Iterator
 {
-  using iterator_category = std::forward_iterator_tag;
+  using iterator_category =
+      std::conditional_t<HasPrev<NodeType>, std::bidirectional_iterator_tag, std::forward_iterator_tag>;
   using difference_type = std::ptrdiff_t;
   using value_type = NodeType;
   using pointer = NodeType*;
   using reference = NodeType&;
 
-  explicit Iterator(pointer ptr) : m_ptr(ptr) {}
+  Iterator() = default;
+  // last points at container's member holding the last node, needed to step back from end()
+  explicit Iterator(pointer ptr, pointer const* last = nullptr) : m_ptr(ptr), m_last(last) {}
 
   reference operator*() const { return *m_ptr; }
-  pointer operator->() { return m_ptr; }
+  pointer operator->() const { return m_ptr; }
+  // Node the iterator points at, nullptr for end()
+  [[nodiscard]] pointer node() const { return m_ptr; }
 
   // Prefix increment
   Iterator& operator++()
@@ -83,688 +209,4679 @@ struct Iterator
   // Postfix increment
   Iterator operator++(int)
   {
-    Iterator tmp{m_ptr};
+    Iterator tmp{*this};
     ++(*this);
     return tmp;
   }
 
-  Iterator operator+(size_t noOfSteps)
+  // Prefix decrement
+  Iterator& operator--()
+    requires HasPrev<NodeType>
+  {
+    m_ptr = m_ptr == nullptr ? *m_last : m_ptr->prev;
+    return *this;
+  }
+
+  // Postfix decrement
+  Iterator operator--(int)
+    requires HasPrev<NodeType>
+  {
+    Iterator tmp{*this};
+    --(*this);
+    return tmp;
+  }
+
+  Iterator operator+(size_t noOfSteps) const
   {
     pointer ptrCopy{m_ptr};
-    for (uint16_t i{}; i < noOfSteps; ++i)
+    for (size_t i{}; i < noOfSteps; ++i)
     {
       ptrCopy = ptrCopy->next;
     }
-    return Iterator{ptrCopy};
+    return Iterator{ptrCopy, m_last};
   }
 
   friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_ptr == b.m_ptr; }
   friend bool operator!=(const Iterator& a, const Iterator& b) { return !(a.m_ptr == b.m_ptr); }
 
 private:
-  pointer m_ptr;
+  pointer m_ptr{};
+  pointer const* m_last{};
 };
 
-}  // namespace it
+// Node allocation policies of node based containers (template template parameter NodeAllocator).
+// nodesAreTransferable tells whether a node may be handed over to another container instance.
+// reserve(count) prepares memory for count more nodes up front, moving an allocator moves its nodes.
 
-namespace cyclic_buffer
+// Every node is a separate new/delete
+template <typename Node>
+struct HeapNodeAllocator
 {
-using it::Iterator;
-using size_t = std::size_t;
+  static constexpr bool nodesAreTransferable{true};
 
-// Cyclic queue
-template <typename T>
-class RingBuffer
-{
-public:
-  explicit RingBuffer(std::size_t capacity) : m_capacity(capacity) {}
-  ~RingBuffer();
+  template <typename... Args>
+  Node* create(Args&&... args)
+  {
+    return new Node{std::forward<Args>(args)...};
+  }
 
-  [[nodiscard]] size_t size() const;
-  [[nodiscard]] bool isFull() const;
-  [[nodiscard]] bool isEmpty() const;
+  void destroy(Node* node) { delete node; }
 
-  [[nodiscard]] std::optional<T> dequeue();
-  bool enqueue(T item);
+  // Nodes are separate allocations, nothing to prepare
+  void reserve(size_t /*count*/) {}
 
-  T* begin();
-  T* end();
+  // Destroy chain of nodes linked by next, starting at first
+  void destroyAll(Node* first)
+  {
+    for (Node* next{}; first != nullptr; first = next)
+    {
+      next = first->next;
+      delete first;
+    }
+  }
+};
 
-private:
-  const std::size_t m_capacity{};
-  T* m_data = new T[m_capacity];
+// Fixed size memory blocks shared by every PoolNodeAllocator, empty ones are cached per thread.
+inline constexpr size_t slabSize{16 * 1024};
+[[nodiscard]] void* acquireSlab();
+void releaseSlab(void* slab);
 
-  bool m_isFull{false};
-  bool m_isEmpty{true};
+// Nodes are carved out of slabs owned by the allocator, freed nodes go to a free list.
+// destroyAll() returns every slab at once, so chain passed to it must hold all alive nodes.
+template <typename Node>
+class PoolNodeAllocator
+{
+public:
+  static constexpr bool nodesAreTransferable{false};
+
+  PoolNodeAllocator() = default;
+  PoolNodeAllocator(const PoolNodeAllocator&) = delete;
+  // Takes over every slab, nodes of rhs stay valid and belong to the new allocator
+  PoolNodeAllocator(PoolNodeAllocator&& rhs) noexcept;
+  PoolNodeAllocator& operator=(const PoolNodeAllocator&) = delete;
+  // Own slabs have to be released (destroyAll) before
+  PoolNodeAllocator& operator=(PoolNodeAllocator&& rhs) noexcept;
+  ~PoolNodeAllocator() { releaseSlabs(); }
+
+  template <typename... Args>
+  Node* create(Args&&... args);
+  void destroy(Node* node);
+  void destroyAll(Node* first);
+  // Acquire slabs for count more nodes in one go (free list not counted)
+  void reserve(size_t count);
 
-  int64_t m_enqueueIndex{};
-  int64_t m_dequeueIndex{};
+private:
+  union Slot
+  {
+    Slot* nextFree;
+    alignas(Node) std::byte node[sizeof(Node)];
+  };
+
+  struct Slab
+  {
+    Slab* next;
+  };
+
+  static constexpr size_t ms_firstSlotOffset{(sizeof(Slab) + alignof(Slot) - 1) / alignof(Slot) *
+                                              alignof(Slot)};
+  static constexpr size_t ms_slotsPerSlab{(slabSize - ms_firstSlotOffset) / sizeof(Slot)};
+  static_assert(alignof(Slot) <= alignof(std::max_align_t), "Over-aligned nodes are not supported");
+  static_assert(ms_slotsPerSlab >= 8, "Node is too big for pool slab");
+
+  Slot* allocateSlot();
+  void startSlab(void* memory);
+  void releaseSlabs();
+
+  Slab* m_slabs{};
+  Slot* m_freeList{};
+  Slot* m_nextUnused{};
+  Slot* m_slabEnd{};
+  // Slabs acquired by reserve() and not carved yet
+  Slab* m_reserved{};
+  size_t m_noOfReserved{};
 };
 
-template <typename T>
-T* RingBuffer<T>::begin()
+template <typename Node>
+PoolNodeAllocator<Node>::PoolNodeAllocator(PoolNodeAllocator&& rhs) noexcept
+    : m_slabs{std::exchange(rhs.m_slabs, nullptr)},
+      m_freeList{std::exchange(rhs.m_freeList, nullptr)},
+      m_nextUnused{std::exchange(rhs.m_nextUnused, nullptr)},
+      m_slabEnd{std::exchange(rhs.m_slabEnd, nullptr)},
+      m_reserved{std::exchange(rhs.m_reserved, nullptr)},
+      m_noOfReserved{std::exchange(rhs.m_noOfReserved, 0)}
 {
-  return m_data;
 }
 
-template <typename T>
-T* RingBuffer<T>::end()
+template <typename Node>
+PoolNodeAllocator<Node>& PoolNodeAllocator<Node>::operator=(PoolNodeAllocator&& rhs) noexcept
 {
-  return m_data + m_capacity;
+  if (this != &rhs)
+  {
+    releaseSlabs();
+    m_slabs = std::exchange(rhs.m_slabs, nullptr);
+    m_freeList = std::exchange(rhs.m_freeList, nullptr);
+    m_nextUnused = std::exchange(rhs.m_nextUnused, nullptr);
+    m_slabEnd = std::exchange(rhs.m_slabEnd, nullptr);
+    m_reserved = std::exchange(rhs.m_reserved, nullptr);
+    m_noOfReserved = std::exchange(rhs.m_noOfReserved, 0);
+  }
+  return *this;
 }
 
-template <typename T>
-RingBuffer<T>::~RingBuffer()
+template <typename Node>
+template <typename... Args>
+Node* PoolNodeAllocator<Node>::create(Args&&... args)
 {
-  delete[] m_data;
+  Slot* const slot{allocateSlot()};
+  return ::new (static_cast<void*>(slot->node)) Node{std::forward<Args>(args)...};
 }
 
-template <typename T>
-inline size_t RingBuffer<T>::size() const
+template <typename Node>
+void PoolNodeAllocator<Node>::destroy(Node* node)
 {
-  const int64_t distance{m_enqueueIndex - m_dequeueIndex};
-  if (distance < 0)
-  {
-    return m_capacity + distance;
-  }
+  std::destroy_at(node);
+  auto* const slot{reinterpret_cast<Slot*>(node)};
+  slot->nextFree = m_freeList;
+  m_freeList = slot;
+}
 
-  if (m_isFull)
+template <typename Node>
+void PoolNodeAllocator<Node>::destroyAll(Node* first)
+{
+  if constexpr (!std::is_trivially_destructible_v<Node>)
   {
-    return m_capacity;
+    for (Node* next{}; first != nullptr; first = next)
+    {
+      next = first->next;
+      std::destroy_at(first);
+    }
   }
-
-  return distance;
+  releaseSlabs();
 }
 
-template <typename T>
-bool RingBuffer<T>::enqueue(T item)
+template <typename Node>
+typename PoolNodeAllocator<Node>::Slot* PoolNodeAllocator<Node>::allocateSlot()
 {
-  fmt::print("Enqueue called\n");
-
-  if (m_isFull)
+  if (m_freeList != nullptr)
   {
-    fmt::print("Queue is full\n");
-    return false;
+    return std::exchange(m_freeList, m_freeList->nextFree);
   }
-  m_isEmpty = false;
 
-  m_data[m_enqueueIndex] = std::move(item);
-  m_enqueueIndex = (m_enqueueIndex + 1) % m_capacity;
-  if (m_enqueueIndex == m_dequeueIndex)
+  if (m_nextUnused == m_slabEnd)
   {
-    m_isFull = true;
+    if (m_reserved != nullptr)
+    {
+      --m_noOfReserved;
+      startSlab(std::exchange(m_reserved, m_reserved->next));
+    }
+    else
+    {
+      startSlab(acquireSlab());
+    }
   }
-  return true;
+  return m_nextUnused++;
 }
 
-template <typename T>
-inline bool RingBuffer<T>::isFull() const
+template <typename Node>
+void PoolNodeAllocator<Node>::startSlab(void* memory)
 {
-  return m_isFull;
+  auto* const bytes{static_cast<std::byte*>(memory)};
+  m_slabs = ::new (memory) Slab{m_slabs};
+  m_nextUnused = reinterpret_cast<Slot*>(bytes + ms_firstSlotOffset);
+  m_slabEnd = m_nextUnused + ms_slotsPerSlab;
 }
 
-template <typename T>
-inline bool RingBuffer<T>::isEmpty() const
+template <typename Node>
+void PoolNodeAllocator<Node>::reserve(size_t count)
 {
-  return m_isEmpty;
+  const auto available{static_cast<size_t>(m_slabEnd - m_nextUnused) + m_noOfReserved * ms_slotsPerSlab};
+  if (count <= available)
+  {
+    return;
+  }
+  for (size_t noOfSlabs{(count - available + ms_slotsPerSlab - 1) / ms_slotsPerSlab}; noOfSlabs > 0;
+       --noOfSlabs)
+  {
+    m_reserved = ::new (acquireSlab()) Slab{m_reserved};
+    ++m_noOfReserved;
+  }
 }
 
-template <typename T>
-std::optional<T> RingBuffer<T>::dequeue()
+template <typename Node>
+void PoolNodeAllocator<Node>::releaseSlabs()
 {
-  fmt::print("Dequeue called\n");
-  m_isFull = false;
-  if (!m_isEmpty)
+  while (m_slabs != nullptr)
   {
-    const auto nextIndex{(m_dequeueIndex + 1) % static_cast<int64_t>(m_capacity)};
-    if (nextIndex == m_enqueueIndex)
-    {
-      m_isEmpty = true;
-    }
-    const auto returnIndex{m_dequeueIndex};
-    m_dequeueIndex = nextIndex;
-    return {m_data[returnIndex]};
+    releaseSlab(std::exchange(m_slabs, m_slabs->next));
   }
-  return std::nullopt;
+  while (m_reserved != nullptr)
+  {
+    releaseSlab(std::exchange(m_reserved, m_reserved->next));
+  }
+  m_noOfReserved = 0;
+  m_freeList = nullptr;
+  m_nextUnused = nullptr;
+  m_slabEnd = nullptr;
 }
-}  // namespace cyclic_buffer
 
-namespace double_linked_list
-{
-using it::DoubleNode;
-using it::Iterator;
+}  // namespace it
 
-// Ex 1.3.31
-template <typename T>
-class DoubleLinkedList
+namespace wait
 {
-public:
-  DoubleLinkedList() = default;
-  DoubleLinkedList(const DoubleLinkedList&) = delete;
-  DoubleLinkedList(DoubleLinkedList&&) = delete;
-  DoubleLinkedList& operator=(DoubleLinkedList&&) = delete;
-  DoubleLinkedList& operator=(const DoubleLinkedList&) = delete;
-  ~DoubleLinkedList();
-
-  [[nodiscard]] constexpr size_t size() const;
-  [[nodiscard]] constexpr bool isEmpty() const;
-  [[nodiscard]] std::optional<T> front() const;
-  [[nodiscard]] std::optional<T> back() const;
-  [[nodiscard]] std::optional<DoubleNode<T>*> find(const T& item);
-
-  Iterator<DoubleNode<T>> begin() { return Iterator<DoubleNode<T>>{m_left}; }
-  Iterator<DoubleNode<T>> end() { return Iterator<DoubleNode<T>>{nullptr}; }
-
-  void clear();
-  void pushLeft(const T& item);
-  void pushRight(const T& item);
-  bool putBefore(T item, T newItem);
-  bool putAfter(T item, T newItem);
-  bool remove(const T& item);
-
-  void deleteFront();
-  void deleteBack();
+using Clock = std::chrono::steady_clock;
+using Deadline = std::optional<Clock::time_point>;
 
-private:
-  [[nodiscard]] bool putFirst(const T& item);
+// Tell the CPU we are spinning (frees pipeline resources for the sibling hyper-thread)
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
 
-  DoubleNode<T>* m_left{};
-  DoubleNode<T>* m_right{};
+// Notifier policy of queues whose consumers never sleep (default): notify() compiles to nothing, so
+// enqueue keeps its lock-free fast path. Only wait strategies which never park may be used.
+struct NoNotifier
+{
+  static constexpr bool canPark{false};
 
-  size_t m_size{};
+  static constexpr void notify() {}
 };
 
-template <typename T>
-bool DoubleLinkedList<T>::remove(const T& item)
+// Place where consumers of one queue sleep while it is empty.
+// Producers call notify() after publishing an item; the futex is touched only when a consumer sleeps,
+// but every notify() pays a full fence.
+class Notifier
 {
-  auto nodeOpt{find(item)};
-  if (!nodeOpt.has_value())
-  {
-    return false;
-  }
+public:
+  static constexpr bool canPark{true};
 
-  auto* node{nodeOpt.value()};
-  // Get neighbors
-  auto prev{node->prev};
-  auto next{node->next};
+  // Register as sleeper. Queue must be checked again afterwards, then park() and unregister().
+  [[nodiscard]] uint32_t prepareToPark();
+  // Sleep until notify() or deadline
+  void park(uint32_t epoch, Deadline deadline);
+  void unregister();
 
-  // Handle left
-  if (prev != nullptr)
-  {
-    prev->next = next;
-  }
-  else
-  {
-    m_left = next;
-  }
+  void notify();
 
-  // Handle right
-  if (next != nullptr)
-  {
-    next->prev = prev;
-  }
-  else
-  {
-    m_right = prev;
-  }
+private:
+  void wakeAll();
 
-  delete node;
+  std::atomic<uint32_t> m_epoch{};
+  std::atomic<uint32_t> m_noOfSleepers{};
+};
 
-  --m_size;
-  return true;
+inline uint32_t Notifier::prepareToPark()
+{
+  m_noOfSleepers.fetch_add(1, std::memory_order_seq_cst);
+  // Pairs with fence in notify(): either producer sees the sleeper or consumer sees the item
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  return m_epoch.load(std::memory_order_acquire);
 }
 
-template <typename T>
-std::optional<DoubleNode<T>*> DoubleLinkedList<T>::find(const T& item)
+inline void Notifier::unregister()
 {
-  const auto it{std::find_if(begin(), end(), [&item](auto node) { return node.item == item; })};
-  return it == end() ? std::nullopt : std::make_optional(&*it);
+  m_noOfSleepers.fetch_sub(1, std::memory_order_relaxed);
 }
 
-template <typename T>
-bool DoubleLinkedList<T>::putAfter(T item, T newItem)
+inline void Notifier::notify()
 {
-  const auto nodeOpt{find(item)};
-  if (!nodeOpt.has_value())
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_noOfSleepers.load(std::memory_order_relaxed) != 0)
   {
-    return false;
+    m_epoch.fetch_add(1, std::memory_order_release);
+    wakeAll();
   }
+}
 
-  auto* node{*nodeOpt};
-  auto* next{node->next};
-  auto* newNode{new DoubleNode<T>{std::move(newItem), next, node}};
+// Wait strategies, used as WaitStrategy template argument of blocking dequeue functions.
+// Strategies with mayPark need a queue whose notifier policy is Notifier.
+// Lowest latency, keeps the core busy
+struct BusySpin
+{
+  static constexpr bool mayPark{false};
 
-  node->next = newNode;
-  if (next != nullptr)
-  {
-    next->prev = newNode;
-  }
-  else
-  {
-    m_right = newNode;
-  }
-  ++m_size;
-  return true;
-}
+  static constexpr bool shouldPark(uint32_t /*attempt*/) { return false; }
+  static void idle(uint32_t /*attempt*/) { cpuRelax(); }
+};
 
-template <typename T>
-bool DoubleLinkedList<T>::putBefore(T item, T newItem)
+// Gives the core away to other runnable threads, still never sleeps
+struct Yield
 {
-  auto nodeOpt{find(item)};
-  if (!nodeOpt.has_value())
-  {
-    return false;
-  }
+  static constexpr bool mayPark{false};
 
-  auto* const node{nodeOpt.value()};
-  auto* const prev{node->prev};
-  auto* const newNode{new DoubleNode<T>{std::move(newItem), node, prev}};
+  static constexpr bool shouldPark(uint32_t /*attempt*/) { return false; }
+  static void idle(uint32_t /*attempt*/) { std::this_thread::yield(); }
+};
 
-  node->prev = newNode;
+// Spins for a while, then sleeps on futex. Spin budget adapts per thread to recent waits: it moves
+// towards twice the spins that were needed when items arrive while spinning, and shrinks when the
+// thread had to park anyway, so spinning stops paying off for slow producers.
+struct SpinThenPark
+{
+  static constexpr bool mayPark{true};
+  static constexpr uint32_t minSpinLimit{64};
+  static constexpr uint32_t maxSpinLimit{16384};
 
-  if (prev != nullptr)
-  {
-    prev->next = newNode;
-  }
-  else  // Put before leftmost (new leftmost)
+  static bool shouldPark(uint32_t attempt) { return attempt >= spinLimit(); }
+  static void idle(uint32_t /*attempt*/) { cpuRelax(); }
+  static void onWaitEnd(uint32_t attempt, bool hasParked);
+
+  static uint32_t& spinLimit()
   {
-    m_left = newNode;
+    thread_local uint32_t limit{1024};
+    return limit;
   }
+};
 
-  ++m_size;
-  return true;
-}
-
-template <typename T>
-void DoubleLinkedList<T>::deleteBack()
+inline void SpinThenPark::onWaitEnd(uint32_t attempt, bool hasParked)
 {
-  if (isEmpty())
+  auto& limit{spinLimit()};
+  if (hasParked)
   {
+    limit = std::max(minSpinLimit, limit - limit / 8);
     return;
   }
+  // Moving average, one wait moves the limit by 1/8 of the difference
+  const auto target{std::clamp(attempt, minSpinLimit / 2, maxSpinLimit / 2) * 2};
+  limit = target > limit ? limit + (target - limit) / 8 : limit - (limit - target) / 8;
+}
 
-  if (m_left == m_right)
-  {
-    m_left = nullptr;
-  }
+// Sleeps on futex at once, uses no CPU while waiting
+struct Park
+{
+  static constexpr bool mayPark{true};
 
-  auto* prev{m_right->prev};
-  delete m_right;
+  static constexpr bool shouldPark(uint32_t /*attempt*/) { return true; }
+  static void idle(uint32_t /*attempt*/) {}
+};
+
+// Strategy used by dequeueWait()/dequeueFor() when none is given
+template <typename NotifierPolicy>
+using DefaultStrategy = std::conditional_t<NotifierPolicy::canPark, SpinThenPark, Yield>;
+
+// Retry tryDequeue() until it returns an item or deadline passes
+template <typename WaitStrategy, typename TryDequeue, typename NotifierPolicy>
+auto waitForItem(TryDequeue tryDequeue, [[maybe_unused]] NotifierPolicy& notifier, Deadline deadline)
+    -> decltype(tryDequeue())
+{
+  static_assert(NotifierPolicy::canPark || !WaitStrategy::mayPark,
+                "Parking wait strategy needs a queue with wait::Notifier policy");
+
+  bool hasParked{false};
+  for (uint32_t attempt{};; ++attempt)
+  {
+    if (auto item{tryDequeue()})
+    {
+      if constexpr (requires { WaitStrategy::onWaitEnd(attempt, hasParked); })
+      {
+        WaitStrategy::onWaitEnd(attempt, hasParked);
+      }
+      return item;
+    }
+    if (deadline.has_value() && Clock::now() >= *deadline)
+    {
+      return std::nullopt;
+    }
+
+    if (!WaitStrategy::shouldPark(attempt))
+    {
+      WaitStrategy::idle(attempt);
+      continue;
+    }
+
+    if constexpr (NotifierPolicy::canPark)
+    {
+      const auto epoch{notifier.prepareToPark()};
+      auto item{tryDequeue()};
+      if (!item.has_value())
+      {
+        notifier.park(epoch, deadline);
+        hasParked = true;
+      }
+      notifier.unregister();
+      if (item.has_value())
+      {
+        return item;
+      }
+    }
+  }
+}
+}  // namespace wait
+
+// Hazard pointers (Michael 2004) for lock-free structures whose nodes are freed while other threads may
+// still read them. A thread publishes the node it is about to read in a hazard slot; retired nodes are
+// freed only once no slot points at them. At most (slots in use) nodes per thread stay unreclaimed.
+namespace hazard
+{
+// Global slot, reused by other threads once released. Never freed.
+struct alignas(cacheLineSize) Record
+{
+  std::atomic<const void*> pointer{};
+  std::atomic<bool> isActive{};
+  Record* next{};
+};
+
+// One hazard slot of the calling thread. Must be destroyed on the thread which created it.
+class HazardPointer
+{
+public:
+  HazardPointer();
+  ~HazardPointer();
+  HazardPointer(const HazardPointer&) = delete;
+  HazardPointer(HazardPointer&&) = delete;
+  HazardPointer& operator=(const HazardPointer&) = delete;
+  HazardPointer& operator=(HazardPointer&&) = delete;
+
+  // Publish and return current value of source (std::atomic<T*> or std::atomic_ref<T*>).
+  // Pointee stays alive until reset(), next protect() or destruction, provided it is retired only after
+  // being unlinked from source.
+  template <typename Source>
+  auto protect(const Source& source);
+  void reset();
+
+private:
+  Record* m_record;
+};
+
+template <typename Source>
+auto HazardPointer::protect(const Source& source)
+{
+  auto* pointer{source.load(std::memory_order_relaxed)};
+  for (;;)
+  {
+    // seq_cst store/load pair with the fence in reclaim(): either reclaim() sees the slot or we see
+    // that pointer has been unlinked
+    m_record->pointer.store(pointer, std::memory_order_seq_cst);
+    auto* const current{source.load(std::memory_order_seq_cst)};
+    if (current == pointer)
+    {
+      return pointer;
+    }
+    pointer = current;
+  }
+}
+
+inline void HazardPointer::reset()
+{
+  m_record->pointer.store(nullptr, std::memory_order_release);
+}
+
+using Deleter = void (*)(void*);
+
+// Free pointer with deleter once no hazard pointer protects it. Pointer must already be unreachable
+// for threads which did not protect it yet.
+void retire(void* pointer, Deleter deleter);
+
+template <typename T>
+void retire(T* pointer)
+{
+  retire(static_cast<void*>(pointer), [](void* retired) { delete static_cast<T*>(retired); });
+}
+
+// Free every pointer retired by calling thread which is not protected, returns number still waiting.
+// Called by retire() once enough pointers are waiting. Pointers left at thread exit are taken over
+// by the next thread which reclaims.
+size_t reclaim();
+}  // namespace hazard
+
+namespace cyclic_buffer
+{
+using it::Iterator;
+using size_t = std::size_t;
+
+namespace overflow
+{
+// enqueue() on full buffer fails and leaves buffer unchanged
+struct Reject
+{
+};
+
+// enqueue() on full buffer overwrites the oldest item in O(1) and counts it as dropped
+struct OverwriteOldest
+{
+};
+}  // namespace overflow
+
+// Cyclic queue
+// Slots are raw storage: items are constructed on enqueue and destroyed on dequeue, so only queued items
+// are alive and T does not have to be default constructible.
+template <typename T, typename Tracer = trace::NoTrace, typename Overflow = overflow::Reject>
+class RingBuffer
+{
+public:
+  // Walks queued items from the oldest, invalidated by enqueue and dequeue
+  class ItemIterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = T*;
+    using reference = T&;
+
+    ItemIterator() = default;
+    ItemIterator(RingBuffer* ring, size_t position) : m_ring{ring}, m_position{position} {}
+
+    reference operator*() const { return m_ring->m_data[slot()]; }
+    pointer operator->() const { return m_ring->m_data + slot(); }
+
+    // Prefix increment
+    ItemIterator& operator++()
+    {
+      ++m_position;
+      return *this;
+    }
+
+    // Postfix increment
+    ItemIterator operator++(int)
+    {
+      ItemIterator tmp{*this};
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const ItemIterator& a, const ItemIterator& b)
+    {
+      return a.m_position == b.m_position;
+    }
+
+  private:
+    [[nodiscard]] size_t slot() const
+    {
+      return (static_cast<size_t>(m_ring->m_dequeueIndex) + m_position) % m_ring->m_capacity;
+    }
+
+    RingBuffer* m_ring{};
+    // Distance from the oldest item
+    size_t m_position{};
+  };
+
+  explicit RingBuffer(std::size_t capacity) : m_capacity(capacity) {}
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer(RingBuffer&&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+  RingBuffer& operator=(RingBuffer&&) = delete;
+  ~RingBuffer();
+
+  [[nodiscard]] size_t capacity() const;
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] bool isFull() const;
+  [[nodiscard]] bool isEmpty() const;
+
+  [[nodiscard]] std::optional<T> dequeue();
+  bool enqueue(T item);
+
+  // Copy as many items as fit (at most two contiguous runs split at the wrap point).
+  // Return number of transferred items.
+  size_t enqueueBulk(std::span<const T> items);
+  size_t dequeueBulk(std::span<T> items);
+
+  // Zero-copy producer: construct item in place in the next free slot and publish it with commit().
+  // Return nullptr when buffer is full and policy rejects new items. On full OverwriteOldest buffer the
+  // oldest item is dropped by reserve() already, because its slot is reused.
+  // At most one item may be reserved, no other enqueue until commit(). Pending item dies with buffer.
+  template <typename... Args>
+  [[nodiscard]] T* reserve(Args&&... args);
+  void commit();
+
+  // Zero-copy consumer: access the oldest item in place and free its slot with release().
+  // Return nullptr when buffer is empty.
+  [[nodiscard]] T* peek();
+  void release();
+
+  // Number of items overwritten by OverwriteOldest policy, safe to read from any thread
+  [[nodiscard]] uint64_t noOfDropped() const;
+
+  // Queued items from the oldest to the newest, a reserved item is not included
+  ItemIterator begin();
+  ItemIterator end();
+
+private:
+  static constexpr bool ms_overwrite{std::is_same_v<Overflow, overflow::OverwriteOldest>};
+
+  [[nodiscard]] bool makeRoom();
+  void advanceEnqueue();
+  void advanceDequeue();
+  void drop(size_t count);
+  void destroy(size_t first, size_t count);
+
+  static void copyIn(const T* first, size_t count, T* destination);
+  static void moveOut(T* first, size_t count, T* destination);
+
+  static std::allocator<T> ms_allocator;
+  static std::allocator_traits<decltype(ms_allocator)> ms_allocatorTraits;
+
+  const std::size_t m_capacity{};
+  T* m_data{ms_allocatorTraits.allocate(ms_allocator, m_capacity)};
+
+  bool m_isFull{false};
+  bool m_isEmpty{true};
+
+  int64_t m_enqueueIndex{};
+  int64_t m_dequeueIndex{};
+  // Item constructed by reserve() in slot m_enqueueIndex, not committed yet
+  bool m_hasReserved{false};
+
+  std::atomic<uint64_t> m_noOfDropped{};
+};
+
+// Telemetry style buffer, producer never fails, the oldest items are dropped instead
+template <typename T, typename Tracer = trace::NoTrace>
+using LossyRingBuffer = RingBuffer<T, Tracer, overflow::OverwriteOldest>;
+
+template <typename T, typename Tracer, typename Overflow>
+std::allocator<T> RingBuffer<T, Tracer, Overflow>::ms_allocator;
+
+template <typename T, typename Tracer, typename Overflow>
+std::allocator_traits<decltype(RingBuffer<T, Tracer, Overflow>::ms_allocator)>
+    RingBuffer<T, Tracer, Overflow>::ms_allocatorTraits;
+
+template <typename T, typename Tracer, typename Overflow>
+typename RingBuffer<T, Tracer, Overflow>::ItemIterator RingBuffer<T, Tracer, Overflow>::begin()
+{
+  return ItemIterator{this, 0};
+}
+
+template <typename T, typename Tracer, typename Overflow>
+typename RingBuffer<T, Tracer, Overflow>::ItemIterator RingBuffer<T, Tracer, Overflow>::end()
+{
+  return ItemIterator{this, size()};
+}
+
+template <typename T, typename Tracer, typename Overflow>
+RingBuffer<T, Tracer, Overflow>::~RingBuffer()
+{
+  if (m_hasReserved)
+  {
+    ms_allocatorTraits.destroy(ms_allocator, m_data + m_enqueueIndex);
+  }
+  destroy(static_cast<size_t>(m_dequeueIndex), size());
+  ms_allocatorTraits.deallocate(ms_allocator, m_data, m_capacity);
+}
+
+// Destroy count items starting at slot first, wrapping around the end of the slot array
+template <typename T, typename Tracer, typename Overflow>
+void RingBuffer<T, Tracer, Overflow>::destroy(size_t first, size_t count)
+{
+  if constexpr (!std::is_trivially_destructible_v<T>)
+  {
+    const size_t firstRun{std::min(count, m_capacity - first)};
+    std::destroy_n(m_data + first, firstRun);
+    std::destroy_n(m_data, count - firstRun);
+  }
+}
+
+template <typename T, typename Tracer, typename Overflow>
+inline size_t RingBuffer<T, Tracer, Overflow>::capacity() const
+{
+  return m_capacity;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+inline size_t RingBuffer<T, Tracer, Overflow>::size() const
+{
+  const int64_t distance{m_enqueueIndex - m_dequeueIndex};
+  if (distance < 0)
+  {
+    return m_capacity + distance;
+  }
+
+  if (m_isFull)
+  {
+    return m_capacity;
+  }
+
+  return distance;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+bool RingBuffer<T, Tracer, Overflow>::enqueue(T item)
+{
+  if (!makeRoom())
+  {
+    return false;
+  }
+  Tracer::record(this, trace::Event::enqueue);
+
+  ms_allocatorTraits.construct(ms_allocator, m_data + m_enqueueIndex, std::move(item));
+  advanceEnqueue();
+  return true;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+template <typename... Args>
+T* RingBuffer<T, Tracer, Overflow>::reserve(Args&&... args)
+{
+  if (!makeRoom())
+  {
+    return nullptr;
+  }
+
+  T* const slot{m_data + m_enqueueIndex};
+  ms_allocatorTraits.construct(ms_allocator, slot, std::forward<Args>(args)...);
+  m_hasReserved = true;
+  return slot;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+void RingBuffer<T, Tracer, Overflow>::commit()
+{
+  assert(m_hasReserved && "commit() without reserve()");
+  Tracer::record(this, trace::Event::enqueue);
+  m_hasReserved = false;
+  advanceEnqueue();
+}
+
+template <typename T, typename Tracer, typename Overflow>
+T* RingBuffer<T, Tracer, Overflow>::peek()
+{
+  return m_isEmpty ? nullptr : m_data + m_dequeueIndex;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+void RingBuffer<T, Tracer, Overflow>::release()
+{
+  if (m_isEmpty)
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::dequeue);
+  ms_allocatorTraits.destroy(ms_allocator, m_data + m_dequeueIndex);
+  advanceDequeue();
+}
+
+// Return false when buffer is full and policy rejects new items
+template <typename T, typename Tracer, typename Overflow>
+bool RingBuffer<T, Tracer, Overflow>::makeRoom()
+{
+  // Slot m_enqueueIndex holds the reserved item
+  assert(!m_hasReserved && "previous reserve() is not committed");
+  if (m_isFull)
+  {
+    if constexpr (!ms_overwrite)
+    {
+      Tracer::record(this, trace::Event::enqueueRejected);
+      return false;
+    }
+    drop(1);
+  }
+  return true;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+inline void RingBuffer<T, Tracer, Overflow>::advanceEnqueue()
+{
+  m_isEmpty = false;
+  m_enqueueIndex = (m_enqueueIndex + 1) % m_capacity;
+  m_isFull = m_enqueueIndex == m_dequeueIndex;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+inline void RingBuffer<T, Tracer, Overflow>::advanceDequeue()
+{
+  m_isFull = false;
+  m_dequeueIndex = (m_dequeueIndex + 1) % static_cast<int64_t>(m_capacity);
+  m_isEmpty = m_dequeueIndex == m_enqueueIndex;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+inline bool RingBuffer<T, Tracer, Overflow>::isFull() const
+{
+  return m_isFull;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+inline bool RingBuffer<T, Tracer, Overflow>::isEmpty() const
+{
+  return m_isEmpty;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+inline uint64_t RingBuffer<T, Tracer, Overflow>::noOfDropped() const
+{
+  return m_noOfDropped.load(std::memory_order_relaxed);
+}
+
+// Discard count oldest items
+template <typename T, typename Tracer, typename Overflow>
+void RingBuffer<T, Tracer, Overflow>::drop(size_t count)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::drop);
+
+  destroy(static_cast<size_t>(m_dequeueIndex), count);
+  m_dequeueIndex = static_cast<int64_t>((static_cast<size_t>(m_dequeueIndex) + count) % m_capacity);
+  m_isFull = false;
+  m_isEmpty = m_enqueueIndex == m_dequeueIndex;
+  // Single writer, so load + store is enough and avoids a locked instruction
+  m_noOfDropped.store(noOfDropped() + count, std::memory_order_relaxed);
+}
+
+template <typename T, typename Tracer, typename Overflow>
+std::optional<T> RingBuffer<T, Tracer, Overflow>::dequeue()
+{
+  if (m_isEmpty)
+  {
+    Tracer::record(this, trace::Event::dequeueEmpty);
+    return std::nullopt;
+  }
+  Tracer::record(this, trace::Event::dequeue);
+
+  std::optional<T> item{std::move(m_data[m_dequeueIndex])};
+  ms_allocatorTraits.destroy(ms_allocator, m_data + m_dequeueIndex);
+  advanceDequeue();
+  return item;
+}
+
+// Copy items into free (not constructed) slots
+template <typename T, typename Tracer, typename Overflow>
+void RingBuffer<T, Tracer, Overflow>::copyIn(const T* first, size_t count, T* destination)
+{
+  if constexpr (std::is_trivially_copyable_v<T>)
+  {
+    if (count != 0)
+    {
+      std::memcpy(destination, first, count * sizeof(T));
+    }
+  }
+  else
+  {
+    std::uninitialized_copy_n(first, count, destination);
+  }
+}
+
+// Move items out of slots into alive objects, then end lifetime of items left in slots
+template <typename T, typename Tracer, typename Overflow>
+void RingBuffer<T, Tracer, Overflow>::moveOut(T* first, size_t count, T* destination)
+{
+  if constexpr (std::is_trivially_copyable_v<T>)
+  {
+    if (count != 0)
+    {
+      std::memcpy(destination, first, count * sizeof(T));
+    }
+  }
+  else
+  {
+    std::move(first, first + count, destination);
+    std::destroy_n(first, count);
+  }
+}
+
+template <typename T, typename Tracer, typename Overflow>
+size_t RingBuffer<T, Tracer, Overflow>::enqueueBulk(std::span<const T> items)
+{
+  assert(!m_hasReserved && "previous reserve() is not committed");
+  Tracer::record(this, trace::Event::enqueueBulk);
+  if constexpr (ms_overwrite)
+  {
+    // Only the newest m_capacity items can survive
+    if (items.size() > m_capacity)
+    {
+      m_noOfDropped.store(noOfDropped() + items.size() - m_capacity, std::memory_order_relaxed);
+      items = items.last(m_capacity);
+    }
+    const size_t free{m_capacity - size()};
+    drop(items.size() > free ? items.size() - free : 0);
+  }
+
+  const size_t count{std::min(items.size(), m_capacity - size())};
+  if (count == 0)
+  {
+    return 0;
+  }
+
+  const auto enqueueIndex{static_cast<size_t>(m_enqueueIndex)};
+  const size_t firstRun{std::min(count, m_capacity - enqueueIndex)};
+  copyIn(items.data(), firstRun, m_data + enqueueIndex);
+  copyIn(items.data() + firstRun, count - firstRun, m_data);
+
+  m_enqueueIndex = static_cast<int64_t>((enqueueIndex + count) % m_capacity);
+  m_isEmpty = false;
+  m_isFull = m_enqueueIndex == m_dequeueIndex;
+  return count;
+}
+
+template <typename T, typename Tracer, typename Overflow>
+size_t RingBuffer<T, Tracer, Overflow>::dequeueBulk(std::span<T> items)
+{
+  Tracer::record(this, trace::Event::dequeueBulk);
+  const size_t count{std::min(items.size(), size())};
+  if (count == 0)
+  {
+    return 0;
+  }
+
+  const auto dequeueIndex{static_cast<size_t>(m_dequeueIndex)};
+  const size_t firstRun{std::min(count, m_capacity - dequeueIndex)};
+  moveOut(m_data + dequeueIndex, firstRun, items.data());
+  moveOut(m_data, count - firstRun, items.data() + firstRun);
+
+  m_dequeueIndex = static_cast<int64_t>((dequeueIndex + count) % m_capacity);
+  m_isFull = false;
+  m_isEmpty = m_enqueueIndex == m_dequeueIndex;
+  return count;
+}
+
+// Cyclic queue with capacity N known at compile time.
+// Items are stored inline (no heap allocation) and N must be the power of two, so wrapping is a mask.
+// Usable in constant expressions.
+template <typename T, size_t N, typename Tracer = trace::NoTrace>
+class StaticRingBuffer
+{
+  static_assert(std::has_single_bit(N), "StaticRingBuffer capacity must be the power of two");
+
+public:
+  [[nodiscard]] static constexpr size_t capacity() { return N; }
+  [[nodiscard]] constexpr size_t size() const;
+  [[nodiscard]] constexpr bool isFull() const;
+  [[nodiscard]] constexpr bool isEmpty() const;
+
+  [[nodiscard]] constexpr std::optional<T> dequeue();
+  constexpr bool enqueue(T item);
+
+private:
+  static constexpr size_t ms_mask{N - 1};
+
+  std::array<T, N> m_data{};
+
+  // Grow monotonically, slot is (index & ms_mask)
+  size_t m_enqueueIndex{};
+  size_t m_dequeueIndex{};
+};
+
+template <typename T, size_t N, typename Tracer>
+constexpr size_t StaticRingBuffer<T, N, Tracer>::size() const
+{
+  return m_enqueueIndex - m_dequeueIndex;
+}
+
+template <typename T, size_t N, typename Tracer>
+constexpr bool StaticRingBuffer<T, N, Tracer>::isFull() const
+{
+  return size() == N;
+}
+
+template <typename T, size_t N, typename Tracer>
+constexpr bool StaticRingBuffer<T, N, Tracer>::isEmpty() const
+{
+  return m_enqueueIndex == m_dequeueIndex;
+}
+
+template <typename T, size_t N, typename Tracer>
+constexpr bool StaticRingBuffer<T, N, Tracer>::enqueue(T item)
+{
+  if (isFull())
+  {
+    Tracer::record(this, trace::Event::enqueueRejected);
+    return false;
+  }
+  Tracer::record(this, trace::Event::enqueue);
+
+  m_data[m_enqueueIndex++ & ms_mask] = std::move(item);
+  return true;
+}
+
+template <typename T, size_t N, typename Tracer>
+constexpr std::optional<T> StaticRingBuffer<T, N, Tracer>::dequeue()
+{
+  if (isEmpty())
+  {
+    Tracer::record(this, trace::Event::dequeueEmpty);
+    return std::nullopt;
+  }
+  Tracer::record(this, trace::Event::dequeue);
+
+  return {std::move(m_data[m_dequeueIndex++ & ms_mask])};
+}
+
+// Lock-free cyclic queue for exactly one producer thread and one consumer thread.
+// Capacity is rounded up to the power of two, so index wrapping is a mask instead of modulo.
+// Each side keeps a cached copy of the opposite index and reloads it only when the cached value
+// says the queue is full (producer) or empty (consumer).
+// Consumer may sleep in dequeueWait()/dequeueFor() only with NotifierPolicy wait::Notifier
+// (BlockingSpscRingBuffer), which costs every enqueue a fence; by default waiting only spins or yields.
+template <typename T, typename Tracer = trace::NoTrace, typename NotifierPolicy = wait::NoNotifier>
+class SpscRingBuffer
+{
+public:
+  explicit SpscRingBuffer(std::size_t capacity);
+  SpscRingBuffer(const SpscRingBuffer&) = delete;
+  SpscRingBuffer(SpscRingBuffer&&) = delete;
+  SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+  SpscRingBuffer& operator=(SpscRingBuffer&&) = delete;
+  ~SpscRingBuffer();
+
+  [[nodiscard]] size_t capacity() const;
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] bool isFull() const;
+  [[nodiscard]] bool isEmpty() const;
+
+  // Producer thread only
+  bool enqueue(T item);
+  // Consumer thread only
+  [[nodiscard]] std::optional<T> dequeue();
+
+  // Consumer thread only, block until an item arrives
+  template <typename WaitStrategy = wait::DefaultStrategy<NotifierPolicy>>
+  [[nodiscard]] T dequeueWait();
+  // Consumer thread only, block until an item arrives or timeout passes
+  template <typename WaitStrategy = wait::DefaultStrategy<NotifierPolicy>, typename Rep,
+            typename Period>
+  [[nodiscard]] std::optional<T> dequeueFor(std::chrono::duration<Rep, Period> timeout);
+
+private:
+  const std::size_t m_capacity{};
+  const std::size_t m_mask{};
+  T* const m_data{};
+
+  // Written by producer. Indices grow monotonically, slot is (index & m_mask).
+  alignas(cacheLineSize) std::atomic<size_t> m_enqueueIndex{};
+  size_t m_cachedDequeueIndex{};
+
+  // Written by consumer
+  alignas(cacheLineSize) std::atomic<size_t> m_dequeueIndex{};
+  size_t m_cachedEnqueueIndex{};
+
+  // Consumers sleeping in dequeueWait()/dequeueFor(), takes no space with wait::NoNotifier
+  [[no_unique_address]] alignas(NotifierPolicy::canPark ? cacheLineSize : 1) NotifierPolicy m_notifier;
+};
+
+// Consumers may sleep while waiting for items, every enqueue pays a fence to check for sleepers
+template <typename T, typename Tracer = trace::NoTrace>
+using BlockingSpscRingBuffer = SpscRingBuffer<T, Tracer, wait::Notifier>;
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+SpscRingBuffer<T, Tracer, NotifierPolicy>::SpscRingBuffer(std::size_t capacity)
+    : m_capacity{std::bit_ceil(capacity)}, m_mask{m_capacity - 1}, m_data{new T[m_capacity]}
+{
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+SpscRingBuffer<T, Tracer, NotifierPolicy>::~SpscRingBuffer()
+{
+  delete[] m_data;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+inline size_t SpscRingBuffer<T, Tracer, NotifierPolicy>::capacity() const
+{
+  return m_capacity;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+size_t SpscRingBuffer<T, Tracer, NotifierPolicy>::size() const
+{
+  // Dequeue index first, so the enqueue index read later is never behind it.
+  const auto dequeueIndex{m_dequeueIndex.load(std::memory_order_acquire)};
+  const auto enqueueIndex{m_enqueueIndex.load(std::memory_order_acquire)};
+  return std::min(enqueueIndex - dequeueIndex, m_capacity);
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+inline bool SpscRingBuffer<T, Tracer, NotifierPolicy>::isFull() const
+{
+  return size() == m_capacity;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+inline bool SpscRingBuffer<T, Tracer, NotifierPolicy>::isEmpty() const
+{
+  return size() == 0;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+bool SpscRingBuffer<T, Tracer, NotifierPolicy>::enqueue(T item)
+{
+  const auto enqueueIndex{m_enqueueIndex.load(std::memory_order_relaxed)};
+  if (enqueueIndex - m_cachedDequeueIndex == m_capacity)
+  {
+    m_cachedDequeueIndex = m_dequeueIndex.load(std::memory_order_acquire);
+    if (enqueueIndex - m_cachedDequeueIndex == m_capacity)
+    {
+      Tracer::record(this, trace::Event::enqueueRejected);
+      return false;
+    }
+  }
+  Tracer::record(this, trace::Event::enqueue);
+
+  m_data[enqueueIndex & m_mask] = std::move(item);
+  m_enqueueIndex.store(enqueueIndex + 1, std::memory_order_release);
+  m_notifier.notify();
+  return true;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+std::optional<T> SpscRingBuffer<T, Tracer, NotifierPolicy>::dequeue()
+{
+  const auto dequeueIndex{m_dequeueIndex.load(std::memory_order_relaxed)};
+  if (dequeueIndex == m_cachedEnqueueIndex)
+  {
+    m_cachedEnqueueIndex = m_enqueueIndex.load(std::memory_order_acquire);
+    if (dequeueIndex == m_cachedEnqueueIndex)
+    {
+      Tracer::record(this, trace::Event::dequeueEmpty);
+      return std::nullopt;
+    }
+  }
+  Tracer::record(this, trace::Event::dequeue);
+
+  std::optional<T> item{std::move(m_data[dequeueIndex & m_mask])};
+  m_dequeueIndex.store(dequeueIndex + 1, std::memory_order_release);
+  return item;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+template <typename WaitStrategy>
+T SpscRingBuffer<T, Tracer, NotifierPolicy>::dequeueWait()
+{
+  return *wait::waitForItem<WaitStrategy>([this] { return dequeue(); }, m_notifier, std::nullopt);
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+template <typename WaitStrategy, typename Rep, typename Period>
+std::optional<T> SpscRingBuffer<T, Tracer, NotifierPolicy>::dequeueFor(
+    std::chrono::duration<Rep, Period> timeout)
+{
+  const auto deadline{wait::Clock::now() + std::chrono::ceil<wait::Clock::duration>(timeout)};
+  return wait::waitForItem<WaitStrategy>([this] { return dequeue(); }, m_notifier, deadline);
+}
+
+// Bounded lock-free cyclic queue for many producer and many consumer threads.
+// Every slot carries a sequence number which tells for which lap the slot is ready to be written
+// (sequence == index) or read (sequence == index + 1), so a thread claims a slot with a single CAS
+// on the shared index and never takes a lock.
+// Consumers may sleep in dequeueWait()/dequeueFor() only with NotifierPolicy wait::Notifier
+// (BlockingMpmcRingBuffer), which costs every enqueue a fence; by default waiting only spins or yields.
+template <typename T, typename Tracer = trace::NoTrace, typename NotifierPolicy = wait::NoNotifier>
+class MpmcRingBuffer
+{
+public:
+  explicit MpmcRingBuffer(std::size_t capacity);
+  MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+  MpmcRingBuffer(MpmcRingBuffer&&) = delete;
+  MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+  MpmcRingBuffer& operator=(MpmcRingBuffer&&) = delete;
+  ~MpmcRingBuffer();
+
+  [[nodiscard]] size_t capacity() const;
+  // Approximate when other threads are running
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] bool isFull() const;
+  [[nodiscard]] bool isEmpty() const;
+
+  bool enqueue(T item);
+  [[nodiscard]] std::optional<T> dequeue();
+
+  // Block until an item arrives
+  template <typename WaitStrategy = wait::DefaultStrategy<NotifierPolicy>>
+  [[nodiscard]] T dequeueWait();
+  // Block until an item arrives or timeout passes
+  template <typename WaitStrategy = wait::DefaultStrategy<NotifierPolicy>, typename Rep,
+            typename Period>
+  [[nodiscard]] std::optional<T> dequeueFor(std::chrono::duration<Rep, Period> timeout);
+
+private:
+  struct Slot
+  {
+    std::atomic<size_t> sequence{};
+    T item{};
+  };
+
+  // Capacity of one makes "ready to read" and "ready to write" of adjacent laps indistinguishable.
+  static constexpr std::size_t ms_minCapacity{2};
+
+  const std::size_t m_capacity{};
+  const std::size_t m_mask{};
+  Slot* const m_slots{};
+
+  alignas(cacheLineSize) std::atomic<size_t> m_enqueueIndex{};
+  alignas(cacheLineSize) std::atomic<size_t> m_dequeueIndex{};
+
+  // Consumers sleeping in dequeueWait()/dequeueFor(), takes no space with wait::NoNotifier
+  [[no_unique_address]] alignas(NotifierPolicy::canPark ? cacheLineSize : 1) NotifierPolicy m_notifier;
+};
+
+// Consumers may sleep while waiting for items, every enqueue pays a fence to check for sleepers
+template <typename T, typename Tracer = trace::NoTrace>
+using BlockingMpmcRingBuffer = MpmcRingBuffer<T, Tracer, wait::Notifier>;
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+MpmcRingBuffer<T, Tracer, NotifierPolicy>::MpmcRingBuffer(std::size_t capacity)
+    : m_capacity{std::bit_ceil(std::max(capacity, ms_minCapacity))},
+      m_mask{m_capacity - 1},
+      m_slots{new Slot[m_capacity]}
+{
+  for (size_t i{}; i < m_capacity; ++i)
+  {
+    m_slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+MpmcRingBuffer<T, Tracer, NotifierPolicy>::~MpmcRingBuffer()
+{
+  delete[] m_slots;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+inline size_t MpmcRingBuffer<T, Tracer, NotifierPolicy>::capacity() const
+{
+  return m_capacity;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+size_t MpmcRingBuffer<T, Tracer, NotifierPolicy>::size() const
+{
+  const auto dequeueIndex{m_dequeueIndex.load(std::memory_order_acquire)};
+  const auto enqueueIndex{m_enqueueIndex.load(std::memory_order_acquire)};
+  return enqueueIndex > dequeueIndex ? std::min(enqueueIndex - dequeueIndex, m_capacity) : 0;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+inline bool MpmcRingBuffer<T, Tracer, NotifierPolicy>::isFull() const
+{
+  return size() == m_capacity;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+inline bool MpmcRingBuffer<T, Tracer, NotifierPolicy>::isEmpty() const
+{
+  return size() == 0;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+bool MpmcRingBuffer<T, Tracer, NotifierPolicy>::enqueue(T item)
+{
+  auto enqueueIndex{m_enqueueIndex.load(std::memory_order_relaxed)};
+  Slot* slot{};
+  for (;;)
+  {
+    slot = &m_slots[enqueueIndex & m_mask];
+    const auto sequence{slot->sequence.load(std::memory_order_acquire)};
+    const auto lag{static_cast<std::ptrdiff_t>(sequence - enqueueIndex)};
+
+    if (lag == 0)
+    {
+      if (m_enqueueIndex.compare_exchange_weak(enqueueIndex, enqueueIndex + 1,
+                                               std::memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (lag < 0)
+    {
+      // Slot still holds an item from the previous lap
+      Tracer::record(this, trace::Event::enqueueRejected);
+      return false;
+    }
+    else
+    {
+      enqueueIndex = m_enqueueIndex.load(std::memory_order_relaxed);
+    }
+  }
+
+  Tracer::record(this, trace::Event::enqueue);
+  slot->item = std::move(item);
+  slot->sequence.store(enqueueIndex + 1, std::memory_order_release);
+  m_notifier.notify();
+  return true;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+std::optional<T> MpmcRingBuffer<T, Tracer, NotifierPolicy>::dequeue()
+{
+  auto dequeueIndex{m_dequeueIndex.load(std::memory_order_relaxed)};
+  Slot* slot{};
+  for (;;)
+  {
+    slot = &m_slots[dequeueIndex & m_mask];
+    const auto sequence{slot->sequence.load(std::memory_order_acquire)};
+    const auto lag{static_cast<std::ptrdiff_t>(sequence - (dequeueIndex + 1))};
+
+    if (lag == 0)
+    {
+      if (m_dequeueIndex.compare_exchange_weak(dequeueIndex, dequeueIndex + 1,
+                                               std::memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (lag < 0)
+    {
+      // Slot not written yet in this lap
+      Tracer::record(this, trace::Event::dequeueEmpty);
+      return std::nullopt;
+    }
+    else
+    {
+      dequeueIndex = m_dequeueIndex.load(std::memory_order_relaxed);
+    }
+  }
+
+  Tracer::record(this, trace::Event::dequeue);
+  std::optional<T> item{std::move(slot->item)};
+  slot->sequence.store(dequeueIndex + m_capacity, std::memory_order_release);
+  return item;
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+template <typename WaitStrategy>
+T MpmcRingBuffer<T, Tracer, NotifierPolicy>::dequeueWait()
+{
+  return *wait::waitForItem<WaitStrategy>([this] { return dequeue(); }, m_notifier, std::nullopt);
+}
+
+template <typename T, typename Tracer, typename NotifierPolicy>
+template <typename WaitStrategy, typename Rep, typename Period>
+std::optional<T> MpmcRingBuffer<T, Tracer, NotifierPolicy>::dequeueFor(
+    std::chrono::duration<Rep, Period> timeout)
+{
+  const auto deadline{wait::Clock::now() + std::chrono::ceil<wait::Clock::duration>(timeout)};
+  return wait::waitForItem<WaitStrategy>([this] { return dequeue(); }, m_notifier, deadline);
+}
+
+// Named POSIX shared memory object mapped into this process.
+// The process that created it removes the name when destroyed, processes that opened it only unmap.
+class SharedMemory
+{
+public:
+  static SharedMemory create(const std::string& name, size_t size);
+  static SharedMemory open(const std::string& name);
+
+  SharedMemory(const SharedMemory&) = delete;
+  SharedMemory(SharedMemory&& rhs) noexcept;
+  SharedMemory& operator=(const SharedMemory&) = delete;
+  SharedMemory& operator=(SharedMemory&& rhs) noexcept;
+  ~SharedMemory();
+
+  [[nodiscard]] std::byte* data() const { return m_data; }
+  [[nodiscard]] size_t size() const { return m_size; }
+
+private:
+  SharedMemory(std::string name, std::byte* data, size_t size, bool isOwner);
+  void unmap();
+
+  std::string m_name;
+  std::byte* m_data{};
+  size_t m_size{};
+  bool m_isOwner{};
+};
+
+// Lock-free SPSC cyclic queue whose indices and slots live in shared memory, so a producer process and
+// a consumer process on the same host exchange items without syscalls.
+// The region holds only indices (no pointers), so every process may map it at a different address.
+// Items are copied bytewise, hence T must be trivially copyable.
+template <typename T>
+class SharedMemoryRingBuffer
+{
+  static_assert(std::is_trivially_copyable_v<T>, "Items are copied between processes bytewise");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "Cursors must not depend on process local locks");
+
+public:
+  // Create region for at least capacity items (rounded up to the power of two)
+  static SharedMemoryRingBuffer create(const std::string& name, size_t capacity);
+  // Attach to region created by another process
+  static SharedMemoryRingBuffer open(const std::string& name);
+
+  [[nodiscard]] size_t capacity() const;
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] bool isFull() const;
+  [[nodiscard]] bool isEmpty() const;
+
+  // Producer process only
+  bool enqueue(const T& item);
+  // Consumer process only
+  [[nodiscard]] std::optional<T> dequeue();
+
+private:
+  static constexpr uint64_t ms_magic{0x63'68'31'72'69'6e'67'01};  // "ch1ring" + layout version
+
+  struct Header
+  {
+    std::atomic<uint64_t> magic{};
+    uint64_t capacity{};
+    uint64_t itemSize{};
+
+    alignas(cacheLineSize) std::atomic<uint64_t> enqueueIndex{};
+    alignas(cacheLineSize) std::atomic<uint64_t> dequeueIndex{};
+  };
+
+  static constexpr size_t ms_slotsOffset{(sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T)};
+
+  SharedMemoryRingBuffer(SharedMemory memory, uint64_t capacity);
+
+  SharedMemory m_memory;
+  Header* m_header{};
+  T* m_slots{};
+  // Process local copy of the validated capacity, the header may be overwritten by another process
+  uint64_t m_capacity{};
+  uint64_t m_mask{};
+
+  // Process local copies of the opposite cursor, seeded from the header since an opened ring
+  // may already be in use
+  uint64_t m_cachedDequeueIndex{};
+  uint64_t m_cachedEnqueueIndex{};
+};
+
+template <typename T>
+SharedMemoryRingBuffer<T>::SharedMemoryRingBuffer(SharedMemory memory, uint64_t capacity)
+    : m_memory{std::move(memory)},
+      m_header{std::launder(reinterpret_cast<Header*>(m_memory.data()))},
+      m_slots{reinterpret_cast<T*>(m_memory.data() + ms_slotsOffset)},
+      m_capacity{capacity},
+      m_mask{capacity - 1},
+      m_cachedDequeueIndex{m_header->dequeueIndex.load(std::memory_order_acquire)},
+      m_cachedEnqueueIndex{m_header->enqueueIndex.load(std::memory_order_acquire)}
+{
+}
+
+template <typename T>
+SharedMemoryRingBuffer<T> SharedMemoryRingBuffer<T>::create(const std::string& name, size_t capacity)
+{
+  const auto slotCount{std::bit_ceil(std::max<size_t>(capacity, 1))};
+  auto memory{SharedMemory::create(name, ms_slotsOffset + slotCount * sizeof(T))};
+
+  auto* const header{std::construct_at(reinterpret_cast<Header*>(memory.data()))};
+  header->capacity = slotCount;
+  header->itemSize = sizeof(T);
+  // Published last, so a process that sees the magic also sees the initialized header
+  header->magic.store(ms_magic, std::memory_order_release);
+
+  return SharedMemoryRingBuffer{std::move(memory), slotCount};
+}
+
+template <typename T>
+SharedMemoryRingBuffer<T> SharedMemoryRingBuffer<T>::open(const std::string& name)
+{
+  auto memory{SharedMemory::open(name)};
+  if (memory.size() < sizeof(Header))
+  {
+    throw std::runtime_error("Shared memory '" + name + "' is too small for ring buffer");
+  }
+
+  const auto* const header{reinterpret_cast<const Header*>(memory.data())};
+  if (header->magic.load(std::memory_order_acquire) != ms_magic || header->itemSize != sizeof(T))
+  {
+    throw std::runtime_error("Shared memory '" + name + "' does not hold ring buffer of this item type");
+  }
+
+  // Written by another process: read once and check before it is used for masking or sizing
+  const uint64_t capacity{header->capacity};
+  // Division instead of capacity * sizeof(T), which may overflow
+  if (memory.size() < ms_slotsOffset || !std::has_single_bit(capacity) ||
+      capacity > (memory.size() - ms_slotsOffset) / sizeof(T))
+  {
+    throw std::runtime_error("Shared memory '" + name + "' holds ring buffer of invalid capacity");
+  }
+  return SharedMemoryRingBuffer{std::move(memory), capacity};
+}
+
+template <typename T>
+inline size_t SharedMemoryRingBuffer<T>::capacity() const
+{
+  return m_capacity;
+}
+
+template <typename T>
+size_t SharedMemoryRingBuffer<T>::size() const
+{
+  const auto dequeueIndex{m_header->dequeueIndex.load(std::memory_order_acquire)};
+  const auto enqueueIndex{m_header->enqueueIndex.load(std::memory_order_acquire)};
+  return std::min<uint64_t>(enqueueIndex - dequeueIndex, m_capacity);
+}
+
+template <typename T>
+inline bool SharedMemoryRingBuffer<T>::isFull() const
+{
+  return size() == capacity();
+}
+
+template <typename T>
+inline bool SharedMemoryRingBuffer<T>::isEmpty() const
+{
+  return size() == 0;
+}
+
+template <typename T>
+bool SharedMemoryRingBuffer<T>::enqueue(const T& item)
+{
+  const auto enqueueIndex{m_header->enqueueIndex.load(std::memory_order_relaxed)};
+  if (enqueueIndex - m_cachedDequeueIndex == m_capacity)
+  {
+    m_cachedDequeueIndex = m_header->dequeueIndex.load(std::memory_order_acquire);
+    if (enqueueIndex - m_cachedDequeueIndex == m_capacity)
+    {
+      return false;
+    }
+  }
+
+  std::memcpy(m_slots + (enqueueIndex & m_mask), &item, sizeof(T));
+  m_header->enqueueIndex.store(enqueueIndex + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+std::optional<T> SharedMemoryRingBuffer<T>::dequeue()
+{
+  const auto dequeueIndex{m_header->dequeueIndex.load(std::memory_order_relaxed)};
+  if (dequeueIndex == m_cachedEnqueueIndex)
+  {
+    m_cachedEnqueueIndex = m_header->enqueueIndex.load(std::memory_order_acquire);
+    if (dequeueIndex == m_cachedEnqueueIndex)
+    {
+      return std::nullopt;
+    }
+  }
+
+  T item{};
+  std::memcpy(&item, m_slots + (dequeueIndex & m_mask), sizeof(T));
+  m_header->dequeueIndex.store(dequeueIndex + 1, std::memory_order_release);
+  return {item};
+}
+
+// Byte cyclic queue whose pages are mapped twice, back to back, in virtual memory (memfd + double mmap).
+// Reading or writing past the end of the first mapping lands at the beginning of the buffer, so every
+// readable or writable window, even one crossing the wrap point, is a single contiguous span.
+// Capacity is rounded up to the power of two multiple of the page size.
+class MirroredByteRingBuffer
+{
+public:
+  explicit MirroredByteRingBuffer(size_t capacity);
+  MirroredByteRingBuffer(const MirroredByteRingBuffer&) = delete;
+  MirroredByteRingBuffer(MirroredByteRingBuffer&&) = delete;
+  MirroredByteRingBuffer& operator=(const MirroredByteRingBuffer&) = delete;
+  MirroredByteRingBuffer& operator=(MirroredByteRingBuffer&&) = delete;
+  ~MirroredByteRingBuffer();
+
+  [[nodiscard]] size_t capacity() const { return m_capacity; }
+  [[nodiscard]] size_t size() const { return m_enqueueIndex - m_dequeueIndex; }
+  [[nodiscard]] bool isFull() const { return size() == m_capacity; }
+  [[nodiscard]] bool isEmpty() const { return size() == 0; }
+
+  // All readable bytes, release them with consume()
+  [[nodiscard]] std::span<const std::byte> readable() const;
+  void consume(size_t count);
+
+  // All free space, fill it and publish filled bytes with commit()
+  [[nodiscard]] std::span<std::byte> writable();
+  void commit(size_t count);
+
+  // Copy as many bytes as fit / are available, return number of transferred bytes
+  size_t write(std::span<const std::byte> bytes);
+  size_t read(std::span<std::byte> bytes);
+
+private:
+  const size_t m_capacity{};
+  const size_t m_mask{};
+  std::byte* m_data{};
+
+  uint64_t m_enqueueIndex{};
+  uint64_t m_dequeueIndex{};
+};
+}  // namespace cyclic_buffer
+
+namespace double_linked_list
+{
+using it::DoubleNode;
+using it::Iterator;
+
+// Ex 1.3.31
+template <typename T, typename Tracer = trace::NoTrace,
+          template <typename> typename NodeAllocator = it::HeapNodeAllocator>
+class DoubleLinkedList
+{
+public:
+  DoubleLinkedList() = default;
+  DoubleLinkedList(const DoubleLinkedList&) = delete;
+  DoubleLinkedList(DoubleLinkedList&&) = delete;
+  DoubleLinkedList& operator=(DoubleLinkedList&&) = delete;
+  DoubleLinkedList& operator=(const DoubleLinkedList&) = delete;
+  ~DoubleLinkedList();
+
+  [[nodiscard]] constexpr size_t size() const;
+  [[nodiscard]] constexpr bool isEmpty() const;
+  [[nodiscard]] std::optional<T> front() const;
+  [[nodiscard]] std::optional<T> back() const;
+  [[nodiscard]] std::optional<DoubleNode<T>*> find(const T& item);
+
+  Iterator<DoubleNode<T>> begin() { return Iterator<DoubleNode<T>>{m_left, &m_right}; }
+  Iterator<DoubleNode<T>> end() { return Iterator<DoubleNode<T>>{nullptr, &m_right}; }
+  Iterator<const DoubleNode<T>> begin() const { return Iterator<const DoubleNode<T>>{m_left, &m_right}; }
+  Iterator<const DoubleNode<T>> end() const { return Iterator<const DoubleNode<T>>{nullptr, &m_right}; }
+
+  void clear();
+  void pushLeft(const T& item);
+  void pushRight(const T& item);
+  bool putBefore(T item, T newItem);
+  bool putAfter(T item, T newItem);
+  bool remove(const T& item);
+
+  // O(1) edits at known position, return iterator to the new item.
+  // end() stands for the sentinel between back and front: insertBefore(end()) appends at the back,
+  // insertAfter(end()) puts item at the front, so both work on an empty list.
+  Iterator<DoubleNode<T>> insertBefore(Iterator<DoubleNode<T>> position, T item);
+  Iterator<DoubleNode<T>> insertAfter(Iterator<DoubleNode<T>> position, T item);
+  // Return iterator to the item following erased one
+  Iterator<DoubleNode<T>> erase(Iterator<DoubleNode<T>> position);
+
+  void deleteFront();
+  void deleteBack();
+
+  // Node transfers between lists, no allocations. Only for allocators whose nodes may change owner.
+  // Move whole other list before position (end() appends), O(1)
+  void splice(Iterator<DoubleNode<T>> position, DoubleLinkedList& other)
+    requires NodeAllocator<DoubleNode<T>>::nodesAreTransferable;
+  // Move [first, last) of other before position, O(moved items) to keep sizes right.
+  // position must not be inside moved range
+  void splice(Iterator<DoubleNode<T>> position, DoubleLinkedList& other, Iterator<DoubleNode<T>> first,
+              Iterator<DoubleNode<T>> last)
+    requires NodeAllocator<DoubleNode<T>>::nodesAreTransferable;
+  // Concatenate, O(1)
+  void append(DoubleLinkedList& other)
+    requires NodeAllocator<DoubleNode<T>>::nodesAreTransferable;
+  // Move [position, end()) to the back of tail, O(moved items) to keep sizes right
+  void split(Iterator<DoubleNode<T>> position, DoubleLinkedList& tail)
+    requires NodeAllocator<DoubleNode<T>>::nodesAreTransferable;
+
+protected:
+  // Node level helpers, node has to belong to this list or be nullptr (past the back for linkBefore,
+  // before the front for linkAfter)
+  DoubleNode<T>* linkBefore(DoubleNode<T>* node, T item);
+  DoubleNode<T>* linkAfter(DoubleNode<T>* node, T item);
+  void unlink(DoubleNode<T>* node);
+  // Link chain first..last (inclusive) of count nodes before node, nullptr links at the back
+  void linkRun(DoubleNode<T>* node, DoubleNode<T>* first, DoubleNode<T>* last, size_t count);
+  // Unlink chain first..last (inclusive) without destroying nodes
+  void unlinkRun(DoubleNode<T>* first, DoubleNode<T>* last, size_t count);
+
+  [[nodiscard]] DoubleNode<T>* leftNode() const { return m_left; }
+  [[nodiscard]] DoubleNode<T>* rightNode() const { return m_right; }
+
+private:
+  [[nodiscard]] bool putFirst(const T& item);
+
+  [[no_unique_address]] NodeAllocator<DoubleNode<T>> m_nodeAllocator;
+  DoubleNode<T>* m_left{};
+  DoubleNode<T>* m_right{};
+
+  size_t m_size{};
+};
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+bool DoubleLinkedList<T, Tracer, NodeAllocator>::remove(const T& item)
+{
+  auto nodeOpt{find(item)};
+  if (!nodeOpt.has_value())
+  {
+    return false;
+  }
+
+  Tracer::record(this, trace::Event::remove);
+  unlink(nodeOpt.value());
+  return true;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::unlink(DoubleNode<T>* node)
+{
+  // Get neighbors
+  auto prev{node->prev};
+  auto next{node->next};
+
+  // Handle left
+  if (prev != nullptr)
+  {
+    prev->next = next;
+  }
+  else
+  {
+    m_left = next;
+  }
+
+  // Handle right
+  if (next != nullptr)
+  {
+    next->prev = prev;
+  }
+  else
+  {
+    m_right = prev;
+  }
+
+  m_nodeAllocator.destroy(node);
+
+  --m_size;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+std::optional<DoubleNode<T>*> DoubleLinkedList<T, Tracer, NodeAllocator>::find(const T& item)
+{
+  const auto it{std::find_if(begin(), end(), [&item](auto node) { return node.item == item; })};
+  return it == end() ? std::nullopt : std::make_optional(&*it);
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+bool DoubleLinkedList<T, Tracer, NodeAllocator>::putAfter(T item, T newItem)
+{
+  const auto nodeOpt{find(item)};
+  if (!nodeOpt.has_value())
+  {
+    return false;
+  }
+
+  Tracer::record(this, trace::Event::insert);
+  linkAfter(*nodeOpt, std::move(newItem));
+  return true;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::linkRun(DoubleNode<T>* node, DoubleNode<T>* first,
+                                                         DoubleNode<T>* last, size_t count)
+{
+  auto* const prev{node != nullptr ? node->prev : m_right};
+  first->prev = prev;
+  last->next = node;
+
+  if (prev != nullptr)
+  {
+    prev->next = first;
+  }
+  else
+  {
+    m_left = first;
+  }
+
+  if (node != nullptr)
+  {
+    node->prev = last;
+  }
+  else
+  {
+    m_right = last;
+  }
+  m_size += count;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::unlinkRun(DoubleNode<T>* first, DoubleNode<T>* last,
+                                                           size_t count)
+{
+  if (first->prev != nullptr)
+  {
+    first->prev->next = last->next;
+  }
+  else
+  {
+    m_left = last->next;
+  }
+
+  if (last->next != nullptr)
+  {
+    last->next->prev = first->prev;
+  }
+  else
+  {
+    m_right = first->prev;
+  }
+  m_size -= count;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::splice(Iterator<DoubleNode<T>> position,
+                                                        DoubleLinkedList& other)
+  requires NodeAllocator<DoubleNode<T>>::nodesAreTransferable
+{
+  if (other.isEmpty() || &other == this)
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::splice);
+
+  linkRun(position.node(), other.m_left, other.m_right, other.m_size);
+  other.m_left = nullptr;
+  other.m_right = nullptr;
+  other.m_size = 0;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::splice(Iterator<DoubleNode<T>> position,
+                                                        DoubleLinkedList& other,
+                                                        Iterator<DoubleNode<T>> first,
+                                                        Iterator<DoubleNode<T>> last)
+  requires NodeAllocator<DoubleNode<T>>::nodesAreTransferable
+{
+  if (first == last)
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::splice);
+
+  auto* const firstNode{first.node()};
+  auto* const lastNode{last.node() != nullptr ? last.node()->prev : other.m_right};
+  size_t count{1};
+  for (auto* node{firstNode}; node != lastNode; node = node->next)
+  {
+    ++count;
+  }
+
+  other.unlinkRun(firstNode, lastNode, count);
+  linkRun(position.node(), firstNode, lastNode, count);
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::append(DoubleLinkedList& other)
+  requires NodeAllocator<DoubleNode<T>>::nodesAreTransferable
+{
+  splice(end(), other);
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::split(Iterator<DoubleNode<T>> position,
+                                                       DoubleLinkedList& tail)
+  requires NodeAllocator<DoubleNode<T>>::nodesAreTransferable
+{
+  tail.splice(tail.end(), *this, position, end());
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+DoubleNode<T>* DoubleLinkedList<T, Tracer, NodeAllocator>::linkAfter(DoubleNode<T>* node, T item)
+{
+  auto* const next{node != nullptr ? node->next : m_left};
+  auto* const newNode{m_nodeAllocator.create(std::move(item), next, node)};
+
+  if (node != nullptr)
+  {
+    node->next = newNode;
+  }
+  else  // Put before leftmost (new leftmost)
+  {
+    m_left = newNode;
+  }
+
+  if (next != nullptr)
+  {
+    next->prev = newNode;
+  }
+  else
+  {
+    m_right = newNode;
+  }
+  ++m_size;
+  return newNode;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+bool DoubleLinkedList<T, Tracer, NodeAllocator>::putBefore(T item, T newItem)
+{
+  auto nodeOpt{find(item)};
+  if (!nodeOpt.has_value())
+  {
+    return false;
+  }
+
+  Tracer::record(this, trace::Event::insert);
+  linkBefore(nodeOpt.value(), std::move(newItem));
+  return true;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+DoubleNode<T>* DoubleLinkedList<T, Tracer, NodeAllocator>::linkBefore(DoubleNode<T>* node, T item)
+{
+  auto* const prev{node != nullptr ? node->prev : m_right};
+  auto* const newNode{m_nodeAllocator.create(std::move(item), node, prev)};
+
+  if (node != nullptr)
+  {
+    node->prev = newNode;
+  }
+  else  // Put after rightmost (new rightmost)
+  {
+    m_right = newNode;
+  }
+
+  if (prev != nullptr)
+  {
+    prev->next = newNode;
+  }
+  else  // Put before leftmost (new leftmost)
+  {
+    m_left = newNode;
+  }
+
+  ++m_size;
+  return newNode;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+Iterator<DoubleNode<T>> DoubleLinkedList<T, Tracer, NodeAllocator>::insertBefore(
+    Iterator<DoubleNode<T>> position, T item)
+{
+  Tracer::record(this, trace::Event::insert);
+  return Iterator<DoubleNode<T>>{linkBefore(position.node(), std::move(item)), &m_right};
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+Iterator<DoubleNode<T>> DoubleLinkedList<T, Tracer, NodeAllocator>::insertAfter(
+    Iterator<DoubleNode<T>> position, T item)
+{
+  Tracer::record(this, trace::Event::insert);
+  return Iterator<DoubleNode<T>>{linkAfter(position.node(), std::move(item)), &m_right};
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+Iterator<DoubleNode<T>> DoubleLinkedList<T, Tracer, NodeAllocator>::erase(
+    Iterator<DoubleNode<T>> position)
+{
+  Tracer::record(this, trace::Event::remove);
+  auto* const next{position.node()->next};
+  unlink(position.node());
+  return Iterator<DoubleNode<T>>{next, &m_right};
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::deleteBack()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::pop);
+
+  if (m_left == m_right)
+  {
+    m_left = nullptr;
+  }
+
+  auto* prev{m_right->prev};
+  m_nodeAllocator.destroy(m_right);
 
   m_right = prev;
   if (m_right != nullptr)
   {
-    m_right->next = nullptr;
+    m_right->next = nullptr;
+  }
+  --m_size;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::deleteFront()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::pop);
+
+  if (m_left == m_right)
+  {
+    m_right = nullptr;
+  }
+
+  auto* next{m_left->next};
+  m_nodeAllocator.destroy(m_left);
+
+  m_left = next;
+  if (m_left != nullptr)
+  {
+    m_left->prev = nullptr;
+  }
+  --m_size;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+std::optional<T> DoubleLinkedList<T, Tracer, NodeAllocator>::front() const
+{
+  if (m_left == nullptr)
+  {
+    return {};
+  }
+  return {m_left->item};
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+std::optional<T> DoubleLinkedList<T, Tracer, NodeAllocator>::back() const
+{
+  if (m_right == nullptr)
+  {
+    return {};
+  }
+  return {m_right->item};
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::clear()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::clear);
+
+  m_nodeAllocator.destroyAll(m_left);
+  m_left = nullptr;
+  m_right = nullptr;
+  m_size = 0;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+DoubleLinkedList<T, Tracer, NodeAllocator>::~DoubleLinkedList()
+{
+  clear();
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+inline bool DoubleLinkedList<T, Tracer, NodeAllocator>::putFirst(const T& item)
+{
+  if (m_size - 1 == 0)
+  {
+    m_left = m_nodeAllocator.create(item);
+    m_right = m_left;
+    return true;
+  }
+  return false;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::pushLeft(const T& item)
+{
+  Tracer::record(this, trace::Event::push);
+  ++m_size;
+
+  if (putFirst(item))
+  {
+    return;
+  }
+
+  m_left->prev = m_nodeAllocator.create(item);
+  m_left->prev->next = m_left;
+  m_left = m_left->prev;
+
+  if (m_right == m_left)
+  {
+    m_right = m_left->next;
+  }
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+void DoubleLinkedList<T, Tracer, NodeAllocator>::pushRight(const T& item)
+{
+  Tracer::record(this, trace::Event::push);
+  ++m_size;
+
+  if (putFirst(item))
+  {
+    return;
+  }
+
+  m_right->next = m_nodeAllocator.create(item);
+  m_right->next->prev = m_right;
+  m_right = m_right->next;
+
+  if (m_left == m_right)
+  {
+    m_left = m_right->prev;
+  }
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+[[nodiscard]] constexpr inline size_t DoubleLinkedList<T, Tracer, NodeAllocator>::size() const
+{
+  return m_size;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+[[nodiscard]] constexpr inline bool DoubleLinkedList<T, Tracer, NodeAllocator>::isEmpty() const
+{
+  return m_size == 0;
+}
+
+// DoubleLinkedList of unique items with hash index item -> node.
+// find, remove, putBefore and putAfter are O(1) on average, iteration keeps list order.
+// Items are keys of the index, so nodes are exposed read only.
+template <typename T, typename Tracer = trace::NoTrace,
+          template <typename> typename NodeAllocator = it::HeapNodeAllocator,
+          typename Hash = std::hash<T>>
+class IndexedDoubleLinkedList : private DoubleLinkedList<T, Tracer, NodeAllocator>
+{
+  using List = DoubleLinkedList<T, Tracer, NodeAllocator>;
+
+public:
+  using List::back;
+  using List::front;
+  using List::isEmpty;
+  using List::size;
+
+  IndexedDoubleLinkedList() = default;
+  IndexedDoubleLinkedList(const IndexedDoubleLinkedList&) = delete;
+  IndexedDoubleLinkedList(IndexedDoubleLinkedList&&) = delete;
+  IndexedDoubleLinkedList& operator=(IndexedDoubleLinkedList&&) = delete;
+  IndexedDoubleLinkedList& operator=(const IndexedDoubleLinkedList&) = delete;
+  ~IndexedDoubleLinkedList() = default;
+
+  [[nodiscard]] Iterator<const DoubleNode<T>> begin() const { return List::begin(); }
+  [[nodiscard]] Iterator<const DoubleNode<T>> end() const { return List::end(); }
+
+  [[nodiscard]] bool contains(const T& item) const;
+  [[nodiscard]] std::optional<const DoubleNode<T>*> find(const T& item) const;
+
+  void clear();
+  // Push, put and insert return false (and change nothing) when new item is already in the list
+  bool pushLeft(const T& item);
+  bool pushRight(const T& item);
+  bool putBefore(const T& item, T newItem);
+  bool putAfter(const T& item, T newItem);
+  bool remove(const T& item);
+
+  void deleteFront();
+  void deleteBack();
+
+private:
+  std::unordered_map<T, DoubleNode<T>*, Hash> m_index;
+};
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator, typename Hash>
+bool IndexedDoubleLinkedList<T, Tracer, NodeAllocator, Hash>::contains(const T& item) const
+{
+  return m_index.contains(item);
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator, typename Hash>
+std::optional<const DoubleNode<T>*> IndexedDoubleLinkedList<T, Tracer, NodeAllocator, Hash>::find(
+    const T& item) const
+{
+  const auto it{m_index.find(item)};
+  return it == m_index.end() ? std::nullopt : std::make_optional(it->second);
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator, typename Hash>
+void IndexedDoubleLinkedList<T, Tracer, NodeAllocator, Hash>::clear()
+{
+  m_index.clear();
+  List::clear();
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator, typename Hash>
+bool IndexedDoubleLinkedList<T, Tracer, NodeAllocator, Hash>::pushLeft(const T& item)
+{
+  if (contains(item))
+  {
+    return false;
+  }
+  List::pushLeft(item);
+  m_index.emplace(item, List::leftNode());
+  return true;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator, typename Hash>
+bool IndexedDoubleLinkedList<T, Tracer, NodeAllocator, Hash>::pushRight(const T& item)
+{
+  if (contains(item))
+  {
+    return false;
+  }
+  List::pushRight(item);
+  m_index.emplace(item, List::rightNode());
+  return true;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator, typename Hash>
+bool IndexedDoubleLinkedList<T, Tracer, NodeAllocator, Hash>::putBefore(const T& item, T newItem)
+{
+  const auto it{m_index.find(item)};
+  if (it == m_index.end() || contains(newItem))
+  {
+    return false;
+  }
+
+  Tracer::record(this, trace::Event::insert);
+  m_index.emplace(newItem, List::linkBefore(it->second, newItem));
+  return true;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator, typename Hash>
+bool IndexedDoubleLinkedList<T, Tracer, NodeAllocator, Hash>::putAfter(const T& item, T newItem)
+{
+  const auto it{m_index.find(item)};
+  if (it == m_index.end() || contains(newItem))
+  {
+    return false;
+  }
+
+  Tracer::record(this, trace::Event::insert);
+  m_index.emplace(newItem, List::linkAfter(it->second, newItem));
+  return true;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator, typename Hash>
+bool IndexedDoubleLinkedList<T, Tracer, NodeAllocator, Hash>::remove(const T& item)
+{
+  const auto it{m_index.find(item)};
+  if (it == m_index.end())
+  {
+    return false;
+  }
+
+  Tracer::record(this, trace::Event::remove);
+  List::unlink(it->second);
+  m_index.erase(it);
+  return true;
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator, typename Hash>
+void IndexedDoubleLinkedList<T, Tracer, NodeAllocator, Hash>::deleteFront()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  m_index.erase(List::leftNode()->item);
+  List::deleteFront();
+}
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator, typename Hash>
+void IndexedDoubleLinkedList<T, Tracer, NodeAllocator, Hash>::deleteBack()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  m_index.erase(List::rightNode()->item);
+  List::deleteBack();
+}
+
+// Base of objects linked by IntrusiveDoubleLinkedList: struct Task : IntrusiveHook<Task> {...};
+// Copying an object does not copy its links.
+template <typename T>
+struct IntrusiveHook
+{
+  IntrusiveHook() = default;
+  IntrusiveHook(const IntrusiveHook&) {}
+  IntrusiveHook& operator=(const IntrusiveHook&) { return *this; }
+  ~IntrusiveHook() = default;
+
+  T* next{};
+  T* prev{};
+};
+
+// Links objects through their embedded hooks, no allocations and no copies of items.
+// List does not own objects, they have to outlive their membership in the list.
+template <typename T, typename Tracer = trace::NoTrace>
+class IntrusiveDoubleLinkedList
+{
+  static_assert(std::is_base_of_v<IntrusiveHook<T>, T>, "T has to derive from IntrusiveHook<T>");
+
+public:
+  IntrusiveDoubleLinkedList() = default;
+  IntrusiveDoubleLinkedList(const IntrusiveDoubleLinkedList&) = delete;
+  IntrusiveDoubleLinkedList(IntrusiveDoubleLinkedList&&) = delete;
+  IntrusiveDoubleLinkedList& operator=(IntrusiveDoubleLinkedList&&) = delete;
+  IntrusiveDoubleLinkedList& operator=(const IntrusiveDoubleLinkedList&) = delete;
+  ~IntrusiveDoubleLinkedList();
+
+  [[nodiscard]] constexpr size_t size() const;
+  [[nodiscard]] constexpr bool isEmpty() const;
+  [[nodiscard]] T* front() const;
+  [[nodiscard]] T* back() const;
+
+  Iterator<T> begin() { return Iterator<T>{m_left, &m_right}; }
+  Iterator<T> end() { return Iterator<T>{nullptr, &m_right}; }
+
+  // Unlink every object
+  void clear();
+  void pushLeft(T& object);
+  void pushRight(T& object);
+  // Object has to be linked in this list
+  void remove(T& object);
+
+  void deleteFront();
+  void deleteBack();
+
+private:
+  void unlink(T& object);
+
+  T* m_left{};
+  T* m_right{};
+
+  size_t m_size{};
+};
+
+template <typename T, typename Tracer>
+IntrusiveDoubleLinkedList<T, Tracer>::~IntrusiveDoubleLinkedList()
+{
+  clear();
+}
+
+template <typename T, typename Tracer>
+void IntrusiveDoubleLinkedList<T, Tracer>::clear()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::clear);
+
+  for (T* next{}; m_left != nullptr; m_left = next)
+  {
+    next = m_left->next;
+    m_left->next = nullptr;
+    m_left->prev = nullptr;
+  }
+  m_right = nullptr;
+  m_size = 0;
+}
+
+template <typename T, typename Tracer>
+void IntrusiveDoubleLinkedList<T, Tracer>::pushLeft(T& object)
+{
+  Tracer::record(this, trace::Event::push);
+  object.prev = nullptr;
+  object.next = m_left;
+
+  if (m_left != nullptr)
+  {
+    m_left->prev = &object;
+  }
+  else
+  {
+    m_right = &object;
+  }
+  m_left = &object;
+  ++m_size;
+}
+
+template <typename T, typename Tracer>
+void IntrusiveDoubleLinkedList<T, Tracer>::pushRight(T& object)
+{
+  Tracer::record(this, trace::Event::push);
+  object.next = nullptr;
+  object.prev = m_right;
+
+  if (m_right != nullptr)
+  {
+    m_right->next = &object;
+  }
+  else
+  {
+    m_left = &object;
+  }
+  m_right = &object;
+  ++m_size;
+}
+
+template <typename T, typename Tracer>
+void IntrusiveDoubleLinkedList<T, Tracer>::remove(T& object)
+{
+  Tracer::record(this, trace::Event::remove);
+  unlink(object);
+}
+
+template <typename T, typename Tracer>
+void IntrusiveDoubleLinkedList<T, Tracer>::unlink(T& object)
+{
+  if (object.prev != nullptr)
+  {
+    object.prev->next = object.next;
+  }
+  else
+  {
+    m_left = object.next;
+  }
+
+  if (object.next != nullptr)
+  {
+    object.next->prev = object.prev;
+  }
+  else
+  {
+    m_right = object.prev;
+  }
+
+  object.next = nullptr;
+  object.prev = nullptr;
+  --m_size;
+}
+
+template <typename T, typename Tracer>
+void IntrusiveDoubleLinkedList<T, Tracer>::deleteFront()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::pop);
+  unlink(*m_left);
+}
+
+template <typename T, typename Tracer>
+void IntrusiveDoubleLinkedList<T, Tracer>::deleteBack()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::pop);
+  unlink(*m_right);
+}
+
+template <typename T, typename Tracer>
+T* IntrusiveDoubleLinkedList<T, Tracer>::front() const
+{
+  return m_left;
+}
+
+template <typename T, typename Tracer>
+T* IntrusiveDoubleLinkedList<T, Tracer>::back() const
+{
+  return m_right;
+}
+
+template <typename T, typename Tracer>
+[[nodiscard]] constexpr inline size_t IntrusiveDoubleLinkedList<T, Tracer>::size() const
+{
+  return m_size;
+}
+
+template <typename T, typename Tracer>
+[[nodiscard]] constexpr inline bool IntrusiveDoubleLinkedList<T, Tracer>::isEmpty() const
+{
+  return m_size == 0;
+}
+
+// Items which find() compares chunk-wide with SIMD instructions
+template <typename T>
+concept SimdSearchable = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+// Unrolled list, every node (chunk) keeps up to chunkCapacity items in an array.
+// Iteration and search touch one node per chunk instead of one per item.
+// Inserting into a full chunk splits it, removal merges chunks which became less than half full.
+template <typename T, typename Tracer = trace::NoTrace>
+class UnrolledLinkedList
+{
+  // next, prev and count, padded to alignment of items
+  static constexpr size_t ms_chunkHeaderSize{(2 * sizeof(void*) + sizeof(size_t) + alignof(T) - 1) /
+                                             alignof(T) * alignof(T)};
+
+  // find() compares this many items at once, capacity is kept a multiple of it so no scalar tail is left
+  static constexpr size_t ms_simdWidth{[]
+                                       {
+#if __has_include(<experimental/simd>)
+                                         if constexpr (SimdSearchable<T>)
+                                         {
+                                           return std::experimental::native_simd<T>::size();
+                                         }
+#endif
+                                         return size_t{1};
+                                       }()};
+
+public:
+  // Chunk (header and items) spans four cache lines
+  static constexpr size_t chunkCapacity{std::max<size_t>(
+      4, (4 * cacheLineSize - ms_chunkHeaderSize) / sizeof(T) / ms_simdWidth * ms_simdWidth)};
+
+private:
+  struct alignas(cacheLineSize) Chunk
+  {
+    Chunk* next{};
+    Chunk* prev{};
+    size_t count{};
+    std::array<T, chunkCapacity> items{};
+  };
+  static_assert(chunkCapacity == 4 || sizeof(Chunk) == 4 * cacheLineSize,
+                "Chunk should fill exactly four cache lines");
+
+public:
+  class ItemIterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = T*;
+    using reference = T&;
+
+    ItemIterator() = default;
+    ItemIterator(Chunk* chunk, size_t index) : m_chunk{chunk}, m_index{index} {}
+
+    reference operator*() const { return m_chunk->items[m_index]; }
+    pointer operator->() const { return &m_chunk->items[m_index]; }
+
+    // Prefix increment
+    ItemIterator& operator++()
+    {
+      if (++m_index == m_chunk->count)
+      {
+        m_chunk = m_chunk->next;
+        m_index = 0;
+      }
+      return *this;
+    }
+
+    // Postfix increment
+    ItemIterator operator++(int)
+    {
+      ItemIterator tmp{*this};
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const ItemIterator& a, const ItemIterator& b) = default;
+
+  private:
+    Chunk* m_chunk{};
+    size_t m_index{};
+  };
+
+  UnrolledLinkedList() = default;
+  UnrolledLinkedList(const UnrolledLinkedList&) = delete;
+  UnrolledLinkedList(UnrolledLinkedList&&) = delete;
+  UnrolledLinkedList& operator=(UnrolledLinkedList&&) = delete;
+  UnrolledLinkedList& operator=(const UnrolledLinkedList&) = delete;
+  ~UnrolledLinkedList();
+
+  [[nodiscard]] constexpr size_t size() const;
+  [[nodiscard]] constexpr bool isEmpty() const;
+  [[nodiscard]] std::optional<T> front() const;
+  [[nodiscard]] std::optional<T> back() const;
+  // Position of the first occurrence of item
+  [[nodiscard]] std::optional<size_t> find(const T& item) const;
+
+  ItemIterator begin() { return ItemIterator{m_left, 0}; }
+  ItemIterator end() { return ItemIterator{}; }
+
+  void clear();
+  void pushLeft(const T& item);
+  void pushRight(const T& item);
+  // Return false when index > size()
+  bool insert(size_t index, T item);
+  // Remove the first occurrence of item
+  bool remove(const T& item);
+  std::optional<T> removeAt(size_t index);
+
+  void deleteFront();
+  void deleteBack();
+
+private:
+  [[nodiscard]] std::pair<Chunk*, size_t> locate(size_t index) const;
+  [[nodiscard]] static size_t findInChunk(const Chunk& chunk, const T& item);
+
+  Chunk* addChunkAfter(Chunk* chunk);
+  void unlinkChunk(Chunk* chunk);
+  void split(Chunk* chunk);
+  void merge(Chunk* into, Chunk* from);
+  T erase(Chunk* chunk, size_t offset);
+
+  Chunk* m_left{};
+  Chunk* m_right{};
+
+  size_t m_size{};
+};
+
+template <typename T, typename Tracer>
+UnrolledLinkedList<T, Tracer>::~UnrolledLinkedList()
+{
+  clear();
+}
+
+template <typename T, typename Tracer>
+void UnrolledLinkedList<T, Tracer>::clear()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::clear);
+
+  for (Chunk* next{}; m_left != nullptr; m_left = next)
+  {
+    next = m_left->next;
+    delete m_left;
+  }
+  m_right = nullptr;
+  m_size = 0;
+}
+
+// New chunk is put after given chunk, nullptr puts it on the left end
+template <typename T, typename Tracer>
+typename UnrolledLinkedList<T, Tracer>::Chunk* UnrolledLinkedList<T, Tracer>::addChunkAfter(Chunk* chunk)
+{
+  auto* const next{chunk == nullptr ? m_left : chunk->next};
+  auto* const newChunk{new Chunk{next, chunk}};
+
+  if (chunk != nullptr)
+  {
+    chunk->next = newChunk;
+  }
+  else
+  {
+    m_left = newChunk;
+  }
+
+  if (next != nullptr)
+  {
+    next->prev = newChunk;
+  }
+  else
+  {
+    m_right = newChunk;
+  }
+  return newChunk;
+}
+
+template <typename T, typename Tracer>
+void UnrolledLinkedList<T, Tracer>::unlinkChunk(Chunk* chunk)
+{
+  if (chunk->prev != nullptr)
+  {
+    chunk->prev->next = chunk->next;
+  }
+  else
+  {
+    m_left = chunk->next;
+  }
+
+  if (chunk->next != nullptr)
+  {
+    chunk->next->prev = chunk->prev;
+  }
+  else
+  {
+    m_right = chunk->prev;
+  }
+  delete chunk;
+}
+
+// Move upper half of full chunk into a new chunk after it
+template <typename T, typename Tracer>
+void UnrolledLinkedList<T, Tracer>::split(Chunk* chunk)
+{
+  auto* const upper{addChunkAfter(chunk)};
+  const size_t half{chunk->count / 2};
+
+  std::move(chunk->items.begin() + static_cast<std::ptrdiff_t>(half),
+            chunk->items.begin() + static_cast<std::ptrdiff_t>(chunk->count), upper->items.begin());
+  upper->count = chunk->count - half;
+  chunk->count = half;
+}
+
+template <typename T, typename Tracer>
+void UnrolledLinkedList<T, Tracer>::merge(Chunk* into, Chunk* from)
+{
+  std::move(from->items.begin(), from->items.begin() + static_cast<std::ptrdiff_t>(from->count),
+            into->items.begin() + static_cast<std::ptrdiff_t>(into->count));
+  into->count += from->count;
+  unlinkChunk(from);
+}
+
+template <typename T, typename Tracer>
+T UnrolledLinkedList<T, Tracer>::erase(Chunk* chunk, size_t offset)
+{
+  auto& items{chunk->items};
+  T item{std::move(items[offset])};
+  std::move(items.begin() + static_cast<std::ptrdiff_t>(offset + 1),
+            items.begin() + static_cast<std::ptrdiff_t>(chunk->count),
+            items.begin() + static_cast<std::ptrdiff_t>(offset));
+  // Release whatever moved-from item still holds
+  items[--chunk->count] = T{};
+  --m_size;
+
+  if (chunk->count == 0)
+  {
+    unlinkChunk(chunk);
+  }
+  else if (chunk->count < chunkCapacity / 2)
+  {
+    if (chunk->next != nullptr && chunk->count + chunk->next->count <= chunkCapacity)
+    {
+      merge(chunk, chunk->next);
+    }
+    else if (chunk->prev != nullptr && chunk->prev->count + chunk->count <= chunkCapacity)
+    {
+      merge(chunk->prev, chunk);
+    }
+  }
+  return item;
+}
+
+// Chunk holding index-th item and position of the item in it, walks from the closer end
+template <typename T, typename Tracer>
+std::pair<typename UnrolledLinkedList<T, Tracer>::Chunk*, size_t> UnrolledLinkedList<T, Tracer>::locate(
+    size_t index) const
+{
+  if (index < m_size / 2)
+  {
+    auto* chunk{m_left};
+    for (; index >= chunk->count; chunk = chunk->next)
+    {
+      index -= chunk->count;
+    }
+    return {chunk, index};
+  }
+
+  auto* chunk{m_right};
+  for (size_t fromRight{m_size - index};; chunk = chunk->prev)
+  {
+    if (fromRight <= chunk->count)
+    {
+      return {chunk, chunk->count - fromRight};
+    }
+    fromRight -= chunk->count;
+  }
+}
+
+template <typename T, typename Tracer>
+size_t UnrolledLinkedList<T, Tracer>::findInChunk(const Chunk& chunk, const T& item)
+{
+  size_t i{};
+#if __has_include(<experimental/simd>)
+  if constexpr (SimdSearchable<T>)
+  {
+    namespace stdx = std::experimental;
+    using Simd = stdx::native_simd<T>;
+    const Simd needle{item};
+    for (; i + Simd::size() <= chunk.count; i += Simd::size())
+    {
+      const Simd lane{&chunk.items[i], stdx::element_aligned};
+      if (const auto equal{lane == needle}; stdx::any_of(equal))
+      {
+        return i + static_cast<size_t>(stdx::find_first_set(equal));
+      }
+    }
+  }
+#endif
+  for (; i < chunk.count; ++i)
+  {
+    if (chunk.items[i] == item)
+    {
+      return i;
+    }
+  }
+  return chunk.count;
+}
+
+template <typename T, typename Tracer>
+std::optional<size_t> UnrolledLinkedList<T, Tracer>::find(const T& item) const
+{
+  size_t base{};
+  for (const auto* chunk{m_left}; chunk != nullptr; chunk = chunk->next)
+  {
+    if (const size_t offset{findInChunk(*chunk, item)}; offset != chunk->count)
+    {
+      return base + offset;
+    }
+    base += chunk->count;
+  }
+  return std::nullopt;
+}
+
+template <typename T, typename Tracer>
+void UnrolledLinkedList<T, Tracer>::pushLeft(const T& item)
+{
+  Tracer::record(this, trace::Event::push);
+  if (m_left == nullptr || m_left->count == chunkCapacity)
+  {
+    addChunkAfter(nullptr);
+  }
+
+  auto& items{m_left->items};
+  std::move_backward(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(m_left->count),
+                     items.begin() + static_cast<std::ptrdiff_t>(m_left->count + 1));
+  items[0] = item;
+  ++m_left->count;
+  ++m_size;
+}
+
+template <typename T, typename Tracer>
+void UnrolledLinkedList<T, Tracer>::pushRight(const T& item)
+{
+  Tracer::record(this, trace::Event::push);
+  if (m_right == nullptr || m_right->count == chunkCapacity)
+  {
+    addChunkAfter(m_right);
+  }
+
+  m_right->items[m_right->count++] = item;
+  ++m_size;
+}
+
+template <typename T, typename Tracer>
+bool UnrolledLinkedList<T, Tracer>::insert(size_t index, T item)
+{
+  if (index > m_size)
+  {
+    return false;
+  }
+  if (index == m_size)
+  {
+    pushRight(item);
+    return true;
+  }
+  Tracer::record(this, trace::Event::insert);
+
+  auto [chunk, offset]{locate(index)};
+  if (chunk->count == chunkCapacity)
+  {
+    split(chunk);
+    if (offset > chunk->count)
+    {
+      offset -= chunk->count;
+      chunk = chunk->next;
+    }
+  }
+
+  auto& items{chunk->items};
+  std::move_backward(items.begin() + static_cast<std::ptrdiff_t>(offset),
+                     items.begin() + static_cast<std::ptrdiff_t>(chunk->count),
+                     items.begin() + static_cast<std::ptrdiff_t>(chunk->count + 1));
+  items[offset] = std::move(item);
+  ++chunk->count;
+  ++m_size;
+  return true;
+}
+
+template <typename T, typename Tracer>
+bool UnrolledLinkedList<T, Tracer>::remove(const T& item)
+{
+  for (auto* chunk{m_left}; chunk != nullptr; chunk = chunk->next)
+  {
+    if (const size_t offset{findInChunk(*chunk, item)}; offset != chunk->count)
+    {
+      Tracer::record(this, trace::Event::remove);
+      erase(chunk, offset);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T, typename Tracer>
+std::optional<T> UnrolledLinkedList<T, Tracer>::removeAt(size_t index)
+{
+  if (index >= m_size)
+  {
+    return std::nullopt;
+  }
+  Tracer::record(this, trace::Event::remove);
+
+  const auto [chunk, offset]{locate(index)};
+  return {erase(chunk, offset)};
+}
+
+template <typename T, typename Tracer>
+void UnrolledLinkedList<T, Tracer>::deleteFront()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::pop);
+  erase(m_left, 0);
+}
+
+template <typename T, typename Tracer>
+void UnrolledLinkedList<T, Tracer>::deleteBack()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::pop);
+  erase(m_right, m_right->count - 1);
+}
+
+template <typename T, typename Tracer>
+std::optional<T> UnrolledLinkedList<T, Tracer>::front() const
+{
+  if (m_left == nullptr)
+  {
+    return {};
+  }
+  return {m_left->items.front()};
+}
+
+template <typename T, typename Tracer>
+std::optional<T> UnrolledLinkedList<T, Tracer>::back() const
+{
+  if (m_right == nullptr)
+  {
+    return {};
+  }
+  return {m_right->items[m_right->count - 1]};
+}
+
+template <typename T, typename Tracer>
+[[nodiscard]] constexpr inline size_t UnrolledLinkedList<T, Tracer>::size() const
+{
+  return m_size;
+}
+
+template <typename T, typename Tracer>
+[[nodiscard]] constexpr inline bool UnrolledLinkedList<T, Tracer>::isEmpty() const
+{
+  return m_size == 0;
+}
+
+// DoubleLinkedList on contiguous arrays: items and prev/next indices (Index wide) are kept in vectors,
+// removed slots go to a free list. Dense for small items and copyable by plain vector copies.
+// Iteration yields items, positions are Index handles stable until the item is removed.
+template <typename T, typename Index = uint32_t, typename Tracer = trace::NoTrace>
+class CompactDoubleLinkedList
+{
+  static_assert(std::is_unsigned_v<Index>, "Index has to be unsigned integer");
+
+public:
+  static constexpr Index npos{std::numeric_limits<Index>::max()};
+
+  class ItemIterator
+  {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = T*;
+    using reference = T&;
+
+    ItemIterator() = default;
+    ItemIterator(CompactDoubleLinkedList* list, Index index) : m_list{list}, m_index{index} {}
+
+    reference operator*() const { return m_list->m_items[m_index]; }
+    pointer operator->() const { return &m_list->m_items[m_index]; }
+    [[nodiscard]] Index index() const { return m_index; }
+
+    // Prefix increment
+    ItemIterator& operator++()
+    {
+      m_index = m_list->m_links[m_index].next;
+      return *this;
+    }
+
+    // Postfix increment
+    ItemIterator operator++(int)
+    {
+      ItemIterator tmp{*this};
+      ++(*this);
+      return tmp;
+    }
+
+    // Prefix decrement
+    ItemIterator& operator--()
+    {
+      m_index = m_index == npos ? m_list->m_right : m_list->m_links[m_index].prev;
+      return *this;
+    }
+
+    // Postfix decrement
+    ItemIterator operator--(int)
+    {
+      ItemIterator tmp{*this};
+      --(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const ItemIterator& a, const ItemIterator& b)
+    {
+      return a.m_index == b.m_index;
+    }
+
+  private:
+    CompactDoubleLinkedList* m_list{};
+    Index m_index{npos};
+  };
+
+  explicit CompactDoubleLinkedList(size_t capacity = 0);
+  // Clone is a plain copy of the arrays (memcpy for trivially copyable items), move steals them
+  // and leaves the source empty
+  CompactDoubleLinkedList(const CompactDoubleLinkedList&) = default;
+  CompactDoubleLinkedList(CompactDoubleLinkedList&& rhs) noexcept;
+  CompactDoubleLinkedList& operator=(const CompactDoubleLinkedList&) = default;
+  CompactDoubleLinkedList& operator=(CompactDoubleLinkedList&& rhs) noexcept;
+  ~CompactDoubleLinkedList() = default;
+
+  [[nodiscard]] constexpr size_t size() const;
+  [[nodiscard]] constexpr bool isEmpty() const;
+  [[nodiscard]] std::optional<T> front() const;
+  [[nodiscard]] std::optional<T> back() const;
+  // Index of the first occurrence of item
+  [[nodiscard]] std::optional<Index> find(const T& item) const;
+  // Slots allocated in the arrays, alive and free
+  [[nodiscard]] size_t capacity() const;
+
+  ItemIterator begin() { return ItemIterator{this, m_left}; }
+  ItemIterator end() { return ItemIterator{this, npos}; }
+
+  void reserve(size_t capacity);
+  void clear();
+  void pushLeft(const T& item);
+  void pushRight(const T& item);
+  bool putBefore(const T& item, T newItem);
+  bool putAfter(const T& item, T newItem);
+  bool remove(const T& item);
+
+  // O(1) edits at known position, return iterator to the new item.
+  // end() stands for the sentinel between back and front: insertBefore(end()) appends at the back,
+  // insertAfter(end()) puts item at the front, so both work on an empty list.
+  ItemIterator insertBefore(ItemIterator position, T item);
+  ItemIterator insertAfter(ItemIterator position, T item);
+  // Return iterator to the item following erased one
+  ItemIterator erase(ItemIterator position);
+
+  void deleteFront();
+  void deleteBack();
+
+private:
+  struct Links
+  {
+    Index next{npos};
+    Index prev{npos};
+  };
+
+  [[nodiscard]] Index allocate(T item);
+  // Link slot between prev and next, npos stands for the list ends
+  void link(Index index, Index prev, Index next);
+  void unlink(Index index);
+
+  std::vector<T> m_items;
+  std::vector<Links> m_links;
+
+  Index m_left{npos};
+  Index m_right{npos};
+  // Free slots are chained through Links::next
+  Index m_free{npos};
+
+  size_t m_size{};
+};
+
+template <typename T, typename Index, typename Tracer>
+CompactDoubleLinkedList<T, Index, Tracer>::CompactDoubleLinkedList(size_t capacity)
+{
+  reserve(capacity);
+}
+
+template <typename T, typename Index, typename Tracer>
+CompactDoubleLinkedList<T, Index, Tracer>::CompactDoubleLinkedList(
+    CompactDoubleLinkedList&& rhs) noexcept
+    : m_items{std::move(rhs.m_items)},
+      m_links{std::move(rhs.m_links)},
+      m_left{std::exchange(rhs.m_left, npos)},
+      m_right{std::exchange(rhs.m_right, npos)},
+      m_free{std::exchange(rhs.m_free, npos)},
+      m_size{std::exchange(rhs.m_size, 0)}
+{
+  rhs.m_items.clear();
+  rhs.m_links.clear();
+}
+
+template <typename T, typename Index, typename Tracer>
+auto CompactDoubleLinkedList<T, Index, Tracer>::operator=(CompactDoubleLinkedList&& rhs) noexcept
+    -> CompactDoubleLinkedList&
+{
+  if (this != &rhs)
+  {
+    m_items = std::move(rhs.m_items);
+    m_links = std::move(rhs.m_links);
+    m_left = std::exchange(rhs.m_left, npos);
+    m_right = std::exchange(rhs.m_right, npos);
+    m_free = std::exchange(rhs.m_free, npos);
+    m_size = std::exchange(rhs.m_size, 0);
+    rhs.m_items.clear();
+    rhs.m_links.clear();
+  }
+  return *this;
+}
+
+template <typename T, typename Index, typename Tracer>
+void CompactDoubleLinkedList<T, Index, Tracer>::reserve(size_t capacity)
+{
+  m_items.reserve(capacity);
+  m_links.reserve(capacity);
+}
+
+template <typename T, typename Index, typename Tracer>
+size_t CompactDoubleLinkedList<T, Index, Tracer>::capacity() const
+{
+  return m_items.size();
+}
+
+template <typename T, typename Index, typename Tracer>
+void CompactDoubleLinkedList<T, Index, Tracer>::clear()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::clear);
+
+  m_items.clear();
+  m_links.clear();
+  m_left = npos;
+  m_right = npos;
+  m_free = npos;
+  m_size = 0;
+}
+
+template <typename T, typename Index, typename Tracer>
+Index CompactDoubleLinkedList<T, Index, Tracer>::allocate(T item)
+{
+  if (m_free != npos)
+  {
+    const Index index{m_free};
+    m_free = m_links[index].next;
+    m_items[index] = std::move(item);
+    return index;
+  }
+
+  if (m_items.size() >= npos)
+  {
+    throw std::length_error("CompactDoubleLinkedList: Index type is too narrow for more items");
+  }
+  m_items.push_back(std::move(item));
+  m_links.emplace_back();
+  return static_cast<Index>(m_items.size() - 1);
+}
+
+template <typename T, typename Index, typename Tracer>
+void CompactDoubleLinkedList<T, Index, Tracer>::link(Index index, Index prev, Index next)
+{
+  m_links[index] = {next, prev};
+
+  if (prev != npos)
+  {
+    m_links[prev].next = index;
+  }
+  else
+  {
+    m_left = index;
+  }
+
+  if (next != npos)
+  {
+    m_links[next].prev = index;
+  }
+  else
+  {
+    m_right = index;
+  }
+  ++m_size;
+}
+
+template <typename T, typename Index, typename Tracer>
+void CompactDoubleLinkedList<T, Index, Tracer>::unlink(Index index)
+{
+  const auto [next, prev]{m_links[index]};
+
+  if (prev != npos)
+  {
+    m_links[prev].next = next;
+  }
+  else
+  {
+    m_left = next;
+  }
+
+  if (next != npos)
+  {
+    m_links[next].prev = prev;
+  }
+  else
+  {
+    m_right = prev;
+  }
+
+  // Release whatever item holds and put slot on the free list
+  m_items[index] = T{};
+  m_links[index] = {m_free, npos};
+  m_free = index;
+  --m_size;
+}
+
+template <typename T, typename Index, typename Tracer>
+std::optional<Index> CompactDoubleLinkedList<T, Index, Tracer>::find(const T& item) const
+{
+  for (Index index{m_left}; index != npos; index = m_links[index].next)
+  {
+    if (m_items[index] == item)
+    {
+      return index;
+    }
+  }
+  return std::nullopt;
+}
+
+template <typename T, typename Index, typename Tracer>
+void CompactDoubleLinkedList<T, Index, Tracer>::pushLeft(const T& item)
+{
+  Tracer::record(this, trace::Event::push);
+  link(allocate(item), npos, m_left);
+}
+
+template <typename T, typename Index, typename Tracer>
+void CompactDoubleLinkedList<T, Index, Tracer>::pushRight(const T& item)
+{
+  Tracer::record(this, trace::Event::push);
+  link(allocate(item), m_right, npos);
+}
+
+template <typename T, typename Index, typename Tracer>
+bool CompactDoubleLinkedList<T, Index, Tracer>::putBefore(const T& item, T newItem)
+{
+  const auto index{find(item)};
+  if (!index.has_value())
+  {
+    return false;
+  }
+  insertBefore(ItemIterator{this, *index}, std::move(newItem));
+  return true;
+}
+
+template <typename T, typename Index, typename Tracer>
+bool CompactDoubleLinkedList<T, Index, Tracer>::putAfter(const T& item, T newItem)
+{
+  const auto index{find(item)};
+  if (!index.has_value())
+  {
+    return false;
+  }
+  insertAfter(ItemIterator{this, *index}, std::move(newItem));
+  return true;
+}
+
+template <typename T, typename Index, typename Tracer>
+bool CompactDoubleLinkedList<T, Index, Tracer>::remove(const T& item)
+{
+  const auto index{find(item)};
+  if (!index.has_value())
+  {
+    return false;
+  }
+  erase(ItemIterator{this, *index});
+  return true;
+}
+
+template <typename T, typename Index, typename Tracer>
+typename CompactDoubleLinkedList<T, Index, Tracer>::ItemIterator
+CompactDoubleLinkedList<T, Index, Tracer>::insertBefore(ItemIterator position, T item)
+{
+  Tracer::record(this, trace::Event::insert);
+  const Index next{position.index()};
+  const Index prev{next == npos ? m_right : m_links[next].prev};
+  const Index index{allocate(std::move(item))};
+  link(index, prev, next);
+  return ItemIterator{this, index};
+}
+
+template <typename T, typename Index, typename Tracer>
+typename CompactDoubleLinkedList<T, Index, Tracer>::ItemIterator
+CompactDoubleLinkedList<T, Index, Tracer>::insertAfter(ItemIterator position, T item)
+{
+  Tracer::record(this, trace::Event::insert);
+  const Index prev{position.index()};
+  const Index next{prev == npos ? m_left : m_links[prev].next};
+  const Index index{allocate(std::move(item))};
+  link(index, prev, next);
+  return ItemIterator{this, index};
+}
+
+template <typename T, typename Index, typename Tracer>
+typename CompactDoubleLinkedList<T, Index, Tracer>::ItemIterator
+CompactDoubleLinkedList<T, Index, Tracer>::erase(ItemIterator position)
+{
+  Tracer::record(this, trace::Event::remove);
+  const Index next{m_links[position.index()].next};
+  unlink(position.index());
+  return ItemIterator{this, next};
+}
+
+template <typename T, typename Index, typename Tracer>
+void CompactDoubleLinkedList<T, Index, Tracer>::deleteFront()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::pop);
+  unlink(m_left);
+}
+
+template <typename T, typename Index, typename Tracer>
+void CompactDoubleLinkedList<T, Index, Tracer>::deleteBack()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::pop);
+  unlink(m_right);
+}
+
+template <typename T, typename Index, typename Tracer>
+std::optional<T> CompactDoubleLinkedList<T, Index, Tracer>::front() const
+{
+  if (m_left == npos)
+  {
+    return {};
+  }
+  return {m_items[m_left]};
+}
+
+template <typename T, typename Index, typename Tracer>
+std::optional<T> CompactDoubleLinkedList<T, Index, Tracer>::back() const
+{
+  if (m_right == npos)
+  {
+    return {};
+  }
+  return {m_items[m_right]};
+}
+
+template <typename T, typename Index, typename Tracer>
+[[nodiscard]] constexpr inline size_t CompactDoubleLinkedList<T, Index, Tracer>::size() const
+{
+  return m_size;
+}
+
+template <typename T, typename Index, typename Tracer>
+[[nodiscard]] constexpr inline bool CompactDoubleLinkedList<T, Index, Tracer>::isEmpty() const
+{
+  return m_size == 0;
+}
+
+// Chase-Lev work-stealing deque (Le et al., "Correct and Efficient Work-Stealing for Weak Memory
+// Models", 2013). One owner thread pushes and pops at the right end with plain loads and stores and a
+// single fence, any number of thieves steal from the left end with a CAS on top; the owner only competes
+// for the last item. The array doubles when full; a thief may still read the old array, so arrays are
+// kept until the deque is destroyed.
+// Items are copied racily before the CAS decides who owns them, so T has to be trivially copyable
+// (pointers or indices of tasks).
+template <typename T, typename Tracer = trace::NoTrace>
+  requires std::is_trivially_copyable_v<T>
+class WorkStealingDeque
+{
+public:
+  explicit WorkStealingDeque(size_t capacity = 32);
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque(WorkStealingDeque&&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+  ~WorkStealingDeque() = default;
+
+  // Approximate when other threads are running
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] bool isEmpty() const;
+  // Owner thread only
+  [[nodiscard]] size_t capacity() const;
+
+  // Owner thread only
+  void pushRight(T item);
+  [[nodiscard]] std::optional<T> popRight();
+  // Any thread, empty result when the deque is empty or another thread took the item first
+  [[nodiscard]] std::optional<T> stealLeft();
+
+private:
+  struct Array
+  {
+    explicit Array(size_t capacity) : mask{capacity - 1}, items{new std::atomic<T>[capacity]} {}
+
+    [[nodiscard]] size_t capacity() const { return mask + 1; }
+    [[nodiscard]] T load(int64_t index) const
+    {
+      return items[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed);
+    }
+    void store(int64_t index, T item)
+    {
+      items[static_cast<size_t>(index) & mask].store(item, std::memory_order_relaxed);
+    }
+
+    const size_t mask{};
+    std::unique_ptr<std::atomic<T>[]> items;
+  };
+
+  [[nodiscard]] Array* grow(Array* array, int64_t bottom, int64_t top);
+
+  // Owner thread only, every array ever used; the last one is current
+  std::vector<std::unique_ptr<Array>> m_arrays;
+
+  alignas(cacheLineSize) std::atomic<int64_t> m_top{};
+  alignas(cacheLineSize) std::atomic<int64_t> m_bottom{};
+  alignas(cacheLineSize) std::atomic<Array*> m_array{};
+};
+
+template <typename T, typename Tracer>
+  requires std::is_trivially_copyable_v<T>
+WorkStealingDeque<T, Tracer>::WorkStealingDeque(size_t capacity)
+{
+  m_arrays.push_back(std::make_unique<Array>(std::bit_ceil(std::max<size_t>(capacity, 2))));
+  m_array.store(m_arrays.back().get(), std::memory_order_relaxed);
+}
+
+template <typename T, typename Tracer>
+  requires std::is_trivially_copyable_v<T>
+size_t WorkStealingDeque<T, Tracer>::size() const
+{
+  const auto bottom{m_bottom.load(std::memory_order_acquire)};
+  const auto top{m_top.load(std::memory_order_acquire)};
+  return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+}
+
+template <typename T, typename Tracer>
+  requires std::is_trivially_copyable_v<T>
+inline bool WorkStealingDeque<T, Tracer>::isEmpty() const
+{
+  return size() == 0;
+}
+
+template <typename T, typename Tracer>
+  requires std::is_trivially_copyable_v<T>
+inline size_t WorkStealingDeque<T, Tracer>::capacity() const
+{
+  return m_array.load(std::memory_order_relaxed)->capacity();
+}
+
+template <typename T, typename Tracer>
+  requires std::is_trivially_copyable_v<T>
+void WorkStealingDeque<T, Tracer>::pushRight(T item)
+{
+  const auto bottom{m_bottom.load(std::memory_order_relaxed)};
+  const auto top{m_top.load(std::memory_order_acquire)};
+  auto* array{m_array.load(std::memory_order_relaxed)};
+  if (bottom - top > static_cast<int64_t>(array->mask))
+  {
+    array = grow(array, bottom, top);
+  }
+
+  Tracer::record(this, trace::Event::push);
+  array->store(bottom, item);
+  // Item has to be visible before thieves see the new bottom
+  std::atomic_thread_fence(std::memory_order_release);
+  m_bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+template <typename T, typename Tracer>
+  requires std::is_trivially_copyable_v<T>
+std::optional<T> WorkStealingDeque<T, Tracer>::popRight()
+{
+  const auto bottom{m_bottom.load(std::memory_order_relaxed) - 1};
+  auto* array{m_array.load(std::memory_order_relaxed)};
+  m_bottom.store(bottom, std::memory_order_relaxed);
+  // Reserve the item before reading top, pairs with the fence in stealLeft()
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto top{m_top.load(std::memory_order_relaxed)};
+
+  if (top > bottom)
+  {
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    Tracer::record(this, trace::Event::dequeueEmpty);
+    return std::nullopt;
+  }
+
+  std::optional<T> item{array->load(bottom)};
+  if (top == bottom)
+  {
+    // Last item, race thieves for it
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed))
+    {
+      item.reset();
+    }
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+  }
+  Tracer::record(this, item ? trace::Event::pop : trace::Event::dequeueEmpty);
+  return item;
+}
+
+template <typename T, typename Tracer>
+  requires std::is_trivially_copyable_v<T>
+std::optional<T> WorkStealingDeque<T, Tracer>::stealLeft()
+{
+  auto top{m_top.load(std::memory_order_acquire)};
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const auto bottom{m_bottom.load(std::memory_order_acquire)};
+
+  if (top >= bottom)
+  {
+    Tracer::record(this, trace::Event::dequeueEmpty);
+    return std::nullopt;
+  }
+
+  // Array stays alive even if the owner grows it meanwhile
+  const auto* array{m_array.load(std::memory_order_acquire)};
+  const T item{array->load(top)};
+  if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+  {
+    Tracer::record(this, trace::Event::dequeueEmpty);
+    return std::nullopt;
+  }
+  Tracer::record(this, trace::Event::dequeue);
+  return item;
+}
+
+template <typename T, typename Tracer>
+  requires std::is_trivially_copyable_v<T>
+auto WorkStealingDeque<T, Tracer>::grow(Array* array, int64_t bottom, int64_t top) -> Array*
+{
+  auto grown{std::make_unique<Array>(array->capacity() * 2)};
+  for (auto i{top}; i < bottom; ++i)
+  {
+    grown->store(i, array->load(i));
+  }
+  m_arrays.push_back(std::move(grown));
+  m_array.store(m_arrays.back().get(), std::memory_order_release);
+  return m_arrays.back().get();
+}
+
+}  // namespace double_linked_list
+
+namespace queue
+{
+using it::Iterator;
+using it::SingleNode;
+
+// Static interface of the queues below, generic code takes "FifoQueue auto& queue" and calls are
+// resolved at compile time (no vptr, calls may be inlined).
+template <typename Q>
+concept FifoQueue = requires(Q queue, const Q constQueue, typename Q::value_type item, size_t k) {
+  queue.enqueue(std::move(item));
+  { queue.dequeue() } -> std::convertible_to<typename Q::value_type>;
+  { constQueue.isEmpty() } -> std::convertible_to<bool>;
+  { constQueue.size() } -> std::convertible_to<std::size_t>;
+};
+
+// FifoQueue which can also take out k-th item from the front
+template <typename Q>
+concept RemovableQueue = FifoQueue<Q> && requires(Q queue, size_t k) {
+  { queue.remove(k) } -> std::same_as<std::optional<typename Q::value_type>>;
+};
+
+// RemovableQueue whose nodes can be walked from front to back
+template <typename Q>
+concept QueueType = RemovableQueue<Q> && requires(Q queue) {
+  { queue.begin() } -> std::forward_iterator;
+  { queue.end() } -> std::forward_iterator;
+};
+
+// Runtime interface for code which has to pick the queue at runtime, implemented by QueueModel and used
+// through AnyQueue. Every call is virtual; prefer FifoQueue when the type is known at compile time.
+template <typename Item>
+struct Queue
+{
+  Queue() = default;
+  virtual ~Queue() = default;
+  Queue(const Queue&) = delete;
+  Queue(Queue&&) = delete;
+  Queue& operator=(Queue&&) = delete;
+  Queue& operator=(const Queue&) = delete;
+
+  virtual Item dequeue() = 0;
+  virtual void enqueue(Item item) = 0;
+  virtual std::optional<Item> remove(size_t k) = 0;
+
+  [[nodiscard]] virtual bool isEmpty() const = 0;
+  [[nodiscard]] virtual std::size_t size() const = 0;
+};
+
+template <RemovableQueue Q>
+class QueueModel final : public Queue<typename Q::value_type>
+{
+  using Item = typename Q::value_type;
+
+public:
+  template <typename... Args>
+  explicit QueueModel(Args&&... args) : m_queue(std::forward<Args>(args)...)
+  {
+  }
+
+  Item dequeue() override { return m_queue.dequeue(); }
+  void enqueue(Item item) override { m_queue.enqueue(std::move(item)); }
+  std::optional<Item> remove(size_t k) override { return m_queue.remove(k); }
+
+  [[nodiscard]] bool isEmpty() const override { return m_queue.isEmpty(); }
+  [[nodiscard]] std::size_t size() const override { return m_queue.size(); }
+
+private:
+  Q m_queue;
+};
+
+// Type erased owner of any RemovableQueue of Item:
+// AnyQueue<int> q{std::in_place_type<RingQueue<int>>, 64};
+template <typename Item>
+class AnyQueue
+{
+public:
+  using value_type = Item;
+
+  template <RemovableQueue Q, typename... Args>
+    requires std::same_as<typename Q::value_type, Item>
+  explicit AnyQueue(std::in_place_type_t<Q> /*type*/, Args&&... args)
+      : m_queue{std::make_unique<QueueModel<Q>>(std::forward<Args>(args)...)}
+  {
+  }
+
+  Item dequeue() { return m_queue->dequeue(); }
+  void enqueue(Item item) { m_queue->enqueue(std::move(item)); }
+  std::optional<Item> remove(size_t k) { return m_queue->remove(k); }
+
+  [[nodiscard]] bool isEmpty() const { return m_queue->isEmpty(); }
+  [[nodiscard]] std::size_t size() const { return m_queue->size(); }
+
+private:
+  std::unique_ptr<Queue<Item>> m_queue;
+};
+
+// Queue of type FIFO
+// Implementation is based on LinkedList idea
+template <typename Item, typename Tracer = trace::NoTrace,
+          template <typename> typename NodeAllocator = it::HeapNodeAllocator>
+class QueueImpl
+{
+public:
+  using value_type = Item;
+
+  QueueImpl() = default;
+  // Iterative, memory for all nodes is reserved up front
+  QueueImpl(const QueueImpl& rhs);
+  // O(1), nodes change owner together with the allocator, rhs is left empty
+  QueueImpl(QueueImpl&& rhs) noexcept;
+  QueueImpl& operator=(const QueueImpl& rhs);
+  QueueImpl& operator=(QueueImpl&& rhs) noexcept;
+  ~QueueImpl();
+
+  void enqueue(Item item);
+  Item dequeue();
+  std::optional<Item> remove(size_t k);
+
+  [[nodiscard]] bool isEmpty() const;
+  [[nodiscard]] std::size_t size() const;
+  Iterator<SingleNode<Item>> begin();
+  Iterator<SingleNode<Item>> end();
+
+  void clear();
+
+  // Node transfers between queues, no allocations. Only for allocators whose nodes may change owner.
+  // Move all items of other to the back, O(1)
+  void append(QueueImpl& other)
+    requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable;
+  // Move items after position to the back of tail, O(moved items) to keep sizes right
+  void splitAfter(Iterator<SingleNode<Item>> position, QueueImpl& tail)
+    requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable;
+  // Move first count items (all when fewer) to the back of other, O(count)
+  void moveFrontTo(QueueImpl& other, size_t count)
+    requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable;
+
+private:
+  // Link chain first..last (inclusive) of count nodes at the back
+  void linkRun(SingleNode<Item>* first, SingleNode<Item>* last, size_t count);
+
+  [[no_unique_address]] NodeAllocator<SingleNode<Item>> m_nodeAllocator;
+  SingleNode<Item>* m_left{};
+  SingleNode<Item>* m_right{};
+  std::size_t m_size{};
+};
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+Iterator<SingleNode<Item>> QueueImpl<Item, Tracer, NodeAllocator>::begin()
+{
+  return Iterator<SingleNode<Item>>(m_left);
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+Iterator<SingleNode<Item>> QueueImpl<Item, Tracer, NodeAllocator>::end()
+{
+  return Iterator<SingleNode<Item>>(nullptr);
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+QueueImpl<Item, Tracer, NodeAllocator>::QueueImpl(const QueueImpl& rhs)
+{
+  Tracer::record(this, trace::Event::copy);
+  m_nodeAllocator.reserve(rhs.m_size);
+
+  // Nodes are linked as they are created, so a throwing copy of an item leaves nothing behind
+  try
+  {
+    for (const auto* node{rhs.m_left}; node != nullptr; node = node->next)
+    {
+      auto* const newNode{m_nodeAllocator.create(node->item)};
+      if (m_left == nullptr)
+      {
+        m_left = newNode;
+      }
+      else
+      {
+        m_right->next = newNode;
+      }
+      m_right = newNode;
+      ++m_size;
+    }
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+QueueImpl<Item, Tracer, NodeAllocator>::QueueImpl(QueueImpl&& rhs) noexcept
+    : m_nodeAllocator{std::move(rhs.m_nodeAllocator)},
+      m_left{std::exchange(rhs.m_left, nullptr)},
+      m_right{std::exchange(rhs.m_right, nullptr)},
+      m_size{std::exchange(rhs.m_size, 0)}
+{
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+auto QueueImpl<Item, Tracer, NodeAllocator>::operator=(const QueueImpl& rhs) -> QueueImpl&
+{
+  if (this != &rhs)
+  {
+    QueueImpl copy{rhs};
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+auto QueueImpl<Item, Tracer, NodeAllocator>::operator=(QueueImpl&& rhs) noexcept -> QueueImpl&
+{
+  if (this != &rhs)
+  {
+    clear();
+    m_nodeAllocator = std::move(rhs.m_nodeAllocator);
+    m_left = std::exchange(rhs.m_left, nullptr);
+    m_right = std::exchange(rhs.m_right, nullptr);
+    m_size = std::exchange(rhs.m_size, 0);
+  }
+  return *this;
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+std::optional<Item> QueueImpl<Item, Tracer, NodeAllocator>::remove(size_t k)
+{
+  // If out of range
+  if (k >= size())
+  {
+    return std::nullopt;
   }
-  --m_size;
-}
+  Tracer::record(this, trace::Event::remove);
 
-template <typename T>
-void DoubleLinkedList<T>::deleteFront()
-{
-  if (isEmpty())
+  if (size() == 1 || k == 0)
   {
-    return;
+    return {dequeue()};
   }
 
-  if (m_left == m_right)
+  Iterator<SingleNode<Item>> currentIt{begin()};
+  Iterator<SingleNode<Item>> prevIt{currentIt};
+  for (size_t i{}; i < k; ++i)
   {
-    m_right = nullptr;
+    prevIt = currentIt++;
   }
 
-  auto* next{m_left->next};
-  delete m_left;
+  SingleNode<Item>& prevNode{*prevIt};
+  SingleNode<Item>& currentNode{*currentIt};
+  Item currentNodeItem{std::move(currentNode.item)};
 
-  m_left = next;
-  if (m_left != nullptr)
+  prevNode.next = currentNode.next;
+  m_nodeAllocator.destroy(&currentNode);
+
+  if (size() - 1 == k)
   {
-    m_left->prev = nullptr;
+    m_right = &prevNode;
   }
   --m_size;
+
+  return {currentNodeItem};
 }
 
-template <typename T>
-std::optional<T> DoubleLinkedList<T>::front() const
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void QueueImpl<Item, Tracer, NodeAllocator>::linkRun(SingleNode<Item>* first, SingleNode<Item>* last,
+                                                     size_t count)
 {
+  last->next = nullptr;
   if (m_left == nullptr)
   {
-    return {};
+    m_left = first;
   }
-  return {m_left->item};
+  else
+  {
+    m_right->next = first;
+  }
+  m_right = last;
+  m_size += count;
 }
 
-template <typename T>
-std::optional<T> DoubleLinkedList<T>::back() const
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void QueueImpl<Item, Tracer, NodeAllocator>::append(QueueImpl& other)
+  requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable
 {
-  if (m_right == nullptr)
+  if (other.isEmpty() || &other == this)
   {
-    return {};
+    return;
   }
-  return {m_right->item};
+  Tracer::record(this, trace::Event::splice);
+
+  linkRun(other.m_left, other.m_right, other.m_size);
+  other.m_left = nullptr;
+  other.m_right = nullptr;
+  other.m_size = 0;
 }
 
-template <typename T>
-void DoubleLinkedList<T>::clear()
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void QueueImpl<Item, Tracer, NodeAllocator>::splitAfter(Iterator<SingleNode<Item>> position,
+                                                        QueueImpl& tail)
+  requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable
 {
-  if (isEmpty())
+  auto* const node{position.node()};
+  if (node == nullptr || node->next == nullptr || &tail == this)
   {
     return;
   }
+  Tracer::record(&tail, trace::Event::splice);
 
-  for (DoubleNode<T>* tempNext{}; m_left->next != nullptr;)
+  auto* const first{node->next};
+  size_t count{1};
+  for (auto* moved{first}; moved != m_right; moved = moved->next)
   {
-    tempNext = m_left->next;
-    delete m_left;
-    m_left = tempNext;
+    ++count;
+  }
+
+  node->next = nullptr;
+  tail.linkRun(first, m_right, count);
+  m_right = node;
+  m_size -= count;
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void QueueImpl<Item, Tracer, NodeAllocator>::moveFrontTo(QueueImpl& other, size_t count)
+  requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable
+{
+  if (count == 0 || &other == this || isEmpty())
+  {
+    return;
+  }
+  if (count >= m_size)
+  {
+    other.append(*this);
+    return;
+  }
+  Tracer::record(&other, trace::Event::splice);
+
+  auto* const first{m_left};
+  auto* last{first};
+  for (size_t i{1}; i < count; ++i)
+  {
+    last = last->next;
+  }
+
+  m_left = last->next;
+  m_size -= count;
+  other.linkRun(first, last, count);
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void QueueImpl<Item, Tracer, NodeAllocator>::clear()
+{
+  if (isEmpty())
+  {
+    return;
   }
-  delete m_left;
+  Tracer::record(this, trace::Event::clear);
+
+  m_nodeAllocator.destroyAll(m_left);
   m_left = nullptr;
   m_right = nullptr;
   m_size = 0;
 }
 
-template <typename T>
-DoubleLinkedList<T>::~DoubleLinkedList()
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+QueueImpl<Item, Tracer, NodeAllocator>::~QueueImpl()
 {
   clear();
 }
 
-template <typename T>
-inline bool DoubleLinkedList<T>::putFirst(const T& item)
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+Item QueueImpl<Item, Tracer, NodeAllocator>::dequeue()
 {
-  if (m_size - 1 == 0)
+  if (isEmpty())
   {
-    m_left = new DoubleNode<T>{item};
-    m_right = m_left;
-    return true;
+    Tracer::record(this, trace::Event::dequeueEmpty);
+    return Item{};
   }
-  return false;
+  Tracer::record(this, trace::Event::dequeue);
+
+  --m_size;
+
+  auto* const oldFirst{m_left};
+  m_left = m_left->next;
+
+  const Item oldItem{std::move(oldFirst->item)};
+  m_nodeAllocator.destroy(oldFirst);
+
+  return oldItem;
 }
 
-template <typename T>
-void DoubleLinkedList<T>::pushLeft(const T& item)
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void QueueImpl<Item, Tracer, NodeAllocator>::enqueue(Item item)
 {
+  Tracer::record(this, trace::Event::enqueue);
+  auto oldLast{m_right};
+  m_right = m_nodeAllocator.create(std::move(item));
+
   ++m_size;
 
-  if (putFirst(item))
+  if (m_left == nullptr)
   {
+    m_left = m_right;
     return;
   }
+  oldLast->next = m_right;
+}
 
-  m_left->prev = new DoubleNode<T>{item};
-  m_left->prev->next = m_left;
-  m_left = m_left->prev;
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+[[nodiscard]] inline bool QueueImpl<Item, Tracer, NodeAllocator>::isEmpty() const
+{
+  return m_size == 0;
+}
 
-  if (m_right == m_left)
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+[[nodiscard]] inline std::size_t QueueImpl<Item, Tracer, NodeAllocator>::size() const
+{
+  return m_size;
+}
+
+// Ex 1.3.35
+template <typename T, typename Tracer = trace::NoTrace,
+          template <typename> typename NodeAllocator = it::HeapNodeAllocator>
+struct RandomQueue : public QueueImpl<T, Tracer, NodeAllocator>
+{
+  using QueueImpl<T, Tracer, NodeAllocator>::size;
+  using QueueImpl<T, Tracer, NodeAllocator>::begin;
+
+  T sample();
+};
+
+template <typename T, typename Tracer, template <typename> typename NodeAllocator>
+T RandomQueue<T, Tracer, NodeAllocator>::sample()
+{
+  std::random_device random_device;
+  std::mt19937 random_engine(random_device());
+  std::uniform_int_distribution<size_t> distribution(0, size() - 1);
+
+  const size_t randomNumber = distribution(random_engine);
+
+  return (begin() + randomNumber)->item;
+}
+
+// Unbounded FIFO on a contiguous power-of-two ring, alternative to node based QueueImpl.
+// Capacity doubles when full, items are relocated in at most two runs (split at the wrap point).
+// With shrinkWhenSparse capacity is halved once queue is at most a quarter full.
+template <typename Item, typename Tracer = trace::NoTrace>
+class RingQueue
+{
+public:
+  using value_type = Item;
+
+  explicit RingQueue(size_t capacity = 0, bool shrinkWhenSparse = false);
+  RingQueue(const RingQueue&) = delete;
+  RingQueue(RingQueue&&) = delete;
+  RingQueue& operator=(const RingQueue&) = delete;
+  RingQueue& operator=(RingQueue&&) = delete;
+  ~RingQueue();
+
+  void enqueue(Item item);
+  Item dequeue();
+  // Shift the shorter side of the ring over removed item
+  std::optional<Item> remove(size_t k);
+
+  [[nodiscard]] bool isEmpty() const;
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] std::size_t capacity() const;
+
+  // k-th item counting from the front
+  Item& operator[](size_t k);
+
+  void clear();
+
+private:
+  static constexpr size_t ms_minCapacity{8};
+
+  Item& slot(size_t k);
+  void resize(size_t newCapacity);
+  void shrinkIfSparse();
+  static void relocate(Item* first, size_t count, Item* destination);
+
+  static std::allocator<Item> ms_allocator;
+  static std::allocator_traits<decltype(ms_allocator)> ms_allocatorTraits;
+
+  Item* m_data{};
+  size_t m_capacity{};
+  size_t m_mask{};
+  size_t m_head{};
+  size_t m_size{};
+  const bool m_shrinkWhenSparse{};
+};
+
+template <typename Item, typename Tracer>
+std::allocator<Item> RingQueue<Item, Tracer>::ms_allocator;
+
+template <typename Item, typename Tracer>
+std::allocator_traits<decltype(RingQueue<Item, Tracer>::ms_allocator)>
+    RingQueue<Item, Tracer>::ms_allocatorTraits;
+
+template <typename Item, typename Tracer>
+RingQueue<Item, Tracer>::RingQueue(size_t capacity, bool shrinkWhenSparse)
+    : m_shrinkWhenSparse{shrinkWhenSparse}
+{
+  if (capacity != 0)
   {
-    m_right = m_left->next;
+    resize(std::bit_ceil(capacity));
   }
 }
 
-template <typename T>
-void DoubleLinkedList<T>::pushRight(const T& item)
+template <typename Item, typename Tracer>
+RingQueue<Item, Tracer>::~RingQueue()
+{
+  clear();
+  if (m_data != nullptr)
+  {
+    ms_allocatorTraits.deallocate(ms_allocator, m_data, m_capacity);
+  }
+}
+
+template <typename Item, typename Tracer>
+inline Item& RingQueue<Item, Tracer>::slot(size_t k)
+{
+  return m_data[(m_head + k) & m_mask];
+}
+
+template <typename Item, typename Tracer>
+void RingQueue<Item, Tracer>::relocate(Item* first, size_t count, Item* destination)
+{
+  if constexpr (std::is_trivially_copyable_v<Item>)
+  {
+    if (count != 0)
+    {
+      std::memcpy(destination, first, count * sizeof(Item));
+    }
+  }
+  else
+  {
+    std::uninitialized_move_n(first, count, destination);
+    std::destroy_n(first, count);
+  }
+}
+
+// Unwrap items into new storage, front lands at index 0
+template <typename Item, typename Tracer>
+void RingQueue<Item, Tracer>::resize(size_t newCapacity)
+{
+  auto* const newData{ms_allocatorTraits.allocate(ms_allocator, newCapacity)};
+  if (m_data != nullptr)
+  {
+    const size_t firstRun{std::min(m_size, m_capacity - m_head)};
+    relocate(m_data + m_head, firstRun, newData);
+    relocate(m_data, m_size - firstRun, newData + firstRun);
+    ms_allocatorTraits.deallocate(ms_allocator, m_data, m_capacity);
+  }
+
+  m_data = newData;
+  m_capacity = newCapacity;
+  m_mask = newCapacity - 1;
+  m_head = 0;
+}
+
+template <typename Item, typename Tracer>
+void RingQueue<Item, Tracer>::shrinkIfSparse()
+{
+  if (m_shrinkWhenSparse && m_capacity > ms_minCapacity && m_size <= m_capacity / 4)
+  {
+    resize(m_capacity / 2);
+  }
+}
+
+template <typename Item, typename Tracer>
+void RingQueue<Item, Tracer>::enqueue(Item item)
 {
+  Tracer::record(this, trace::Event::enqueue);
+  if (m_size == m_capacity)
+  {
+    resize(m_capacity == 0 ? ms_minCapacity : m_capacity * 2);
+  }
+  ms_allocatorTraits.construct(ms_allocator, &slot(m_size), std::move(item));
   ++m_size;
+}
 
-  if (putFirst(item))
+template <typename Item, typename Tracer>
+Item RingQueue<Item, Tracer>::dequeue()
+{
+  if (isEmpty())
   {
-    return;
+    Tracer::record(this, trace::Event::dequeueEmpty);
+    return Item{};
   }
+  Tracer::record(this, trace::Event::dequeue);
 
-  m_right->next = new DoubleNode<T>{item};
-  m_right->next->prev = m_right;
-  m_right = m_right->next;
+  Item& front{slot(0)};
+  Item item{std::move(front)};
+  ms_allocatorTraits.destroy(ms_allocator, &front);
+  m_head = (m_head + 1) & m_mask;
+  --m_size;
 
-  if (m_left == m_right)
+  shrinkIfSparse();
+  return item;
+}
+
+template <typename Item, typename Tracer>
+std::optional<Item> RingQueue<Item, Tracer>::remove(size_t k)
+{
+  if (k >= m_size)
   {
-    m_left = m_right->prev;
+    return std::nullopt;
+  }
+  Tracer::record(this, trace::Event::remove);
+
+  Item item{std::move(slot(k))};
+  if (k < m_size / 2)
+  {
+    for (size_t i{k}; i > 0; --i)
+    {
+      slot(i) = std::move(slot(i - 1));
+    }
+    ms_allocatorTraits.destroy(ms_allocator, &slot(0));
+    m_head = (m_head + 1) & m_mask;
+  }
+  else
+  {
+    for (size_t i{k}; i + 1 < m_size; ++i)
+    {
+      slot(i) = std::move(slot(i + 1));
+    }
+    ms_allocatorTraits.destroy(ms_allocator, &slot(m_size - 1));
   }
+  --m_size;
+
+  shrinkIfSparse();
+  return {std::move(item)};
 }
 
-template <typename T>
-[[nodiscard]] constexpr inline size_t DoubleLinkedList<T>::size() const
+template <typename Item, typename Tracer>
+void RingQueue<Item, Tracer>::clear()
 {
-  return m_size;
+  if (isEmpty())
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::clear);
+
+  for (size_t i{}; i < m_size; ++i)
+  {
+    ms_allocatorTraits.destroy(ms_allocator, &slot(i));
+  }
+  m_head = 0;
+  m_size = 0;
 }
 
-template <typename T>
-[[nodiscard]] constexpr inline bool DoubleLinkedList<T>::isEmpty() const
+template <typename Item, typename Tracer>
+inline Item& RingQueue<Item, Tracer>::operator[](size_t k)
+{
+  return slot(k);
+}
+
+template <typename Item, typename Tracer>
+[[nodiscard]] inline bool RingQueue<Item, Tracer>::isEmpty() const
 {
   return m_size == 0;
 }
 
-}  // namespace double_linked_list
+template <typename Item, typename Tracer>
+[[nodiscard]] inline std::size_t RingQueue<Item, Tracer>::size() const
+{
+  return m_size;
+}
 
-namespace queue
+template <typename Item, typename Tracer>
+[[nodiscard]] inline std::size_t RingQueue<Item, Tracer>::capacity() const
 {
-using it::Iterator;
-using it::SingleNode;
+  return m_capacity;
+}
 
-template <typename Item>
-struct Queue
+// Unbounded FIFO on a singly linked chain of fixed size blocks of BlockSize items.
+// Emptied blocks go to a cache and are reused before allocating. By default the cache keeps every
+// drained block, so memory stays at the high-water mark and a queue that stays within it enqueues and
+// dequeues without touching the allocator. Bounded maxSpareBlocks returns the rest to the allocator.
+// Iteration is sequential within a block, remove(k) shifts the shorter side over removed item.
+template <typename Item, typename Tracer = trace::NoTrace,
+          size_t BlockSize = std::max<size_t>(16, 4096 / sizeof(Item))>
+class BlockQueue
 {
-  Queue() = default;
-  virtual ~Queue() = default;
-  Queue(const Queue&) = default;
-  Queue(Queue&&) = delete;
-  Queue& operator=(Queue&&) = delete;
-  Queue& operator=(const Queue&) = delete;
+  struct Block
+  {
+    [[nodiscard]] Item* items() { return std::launder(reinterpret_cast<Item*>(storage)); }
 
-  virtual Item dequeue() = 0;
-  virtual void enqueue(Item item) = 0;
-  virtual std::optional<Item> remove(size_t k) = 0;
+    Block* next{};
+    alignas(Item) std::byte storage[sizeof(Item) * BlockSize];
+  };
 
-  [[nodiscard]] virtual bool isEmpty() const = 0;
-  [[nodiscard]] virtual std::size_t size() const = 0;
+public:
+  using value_type = Item;
 
-  virtual Iterator<SingleNode<Item>> begin() = 0;
-  virtual Iterator<SingleNode<Item>> end() = 0;
+  class ItemIterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = Item;
+    using pointer = Item*;
+    using reference = Item&;
 
-protected:
-  std::size_t m_size{};
-};
+    ItemIterator() = default;
+    ItemIterator(Block* block, size_t index) : m_block{block}, m_index{index} {}
 
-// Queue of type FIFO
-// Implementation is based on LinkedList idea
-template <typename Item>
-class QueueImpl : public Queue<Item>
-{
-  using Queue<Item>::m_size;
+    reference operator*() const { return m_block->items()[m_index]; }
+    pointer operator->() const { return &m_block->items()[m_index]; }
 
-public:
-  QueueImpl() = default;
-  QueueImpl(const QueueImpl&);
-  ~QueueImpl() override;
+    // Prefix increment
+    ItemIterator& operator++()
+    {
+      if (++m_index == BlockSize && m_block->next != nullptr)
+      {
+        m_block = m_block->next;
+        m_index = 0;
+      }
+      return *this;
+    }
+
+    // Postfix increment
+    ItemIterator operator++(int)
+    {
+      ItemIterator tmp{*this};
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const ItemIterator& a, const ItemIterator& b)
+    {
+      return a.m_block == b.m_block && a.m_index == b.m_index;
+    }
 
-  void enqueue(Item item) override;
-  Item dequeue() override;
-  std::optional<Item> remove(size_t k) override;
+  private:
+    Block* m_block{};
+    size_t m_index{};
+  };
+
+  explicit BlockQueue(size_t maxSpareBlocks = std::numeric_limits<size_t>::max());
+  BlockQueue(const BlockQueue&) = delete;
+  BlockQueue(BlockQueue&&) = delete;
+  BlockQueue& operator=(const BlockQueue&) = delete;
+  BlockQueue& operator=(BlockQueue&&) = delete;
+  ~BlockQueue();
+
+  void enqueue(Item item);
+  Item dequeue();
+  std::optional<Item> remove(size_t k);
+
+  [[nodiscard]] bool isEmpty() const;
+  [[nodiscard]] std::size_t size() const;
+  // Blocks waiting in the cache for reuse
+  [[nodiscard]] std::size_t noOfSpareBlocks() const;
 
-  [[nodiscard]] bool isEmpty() const override;
-  [[nodiscard]] std::size_t size() const override;
-  Iterator<SingleNode<Item>> begin() override;
-  Iterator<SingleNode<Item>> end() override;
+  ItemIterator begin() { return ItemIterator{m_head, m_headIndex}; }
+  ItemIterator end() { return ItemIterator{m_tail, m_tailIndex}; }
 
   void clear();
 
 private:
-  void copyNode(SingleNode<Item>* prevLhsNode, SingleNode<Item>* currentRhsNode);
+  [[nodiscard]] Block* acquireBlock();
+  void releaseBlock(Block* block);
+  // Destroy front item and advance head, emptied head block goes back to the cache
+  void popFront();
+  // Keep a single block with both indices at 0 once the last item is gone
+  void resetIfEmpty();
+
+  Block* m_head{};
+  Block* m_tail{};
+  // Front item is m_head->items()[m_headIndex], m_tailIndex is one past the back item in m_tail
+  size_t m_headIndex{};
+  size_t m_tailIndex{};
+  size_t m_size{};
 
-  SingleNode<Item>* m_left{};
-  SingleNode<Item>* m_right{};
+  Block* m_spare{};
+  size_t m_noOfSpare{};
+  const size_t m_maxSpareBlocks{};
 };
 
-template <typename Item>
-Iterator<SingleNode<Item>> QueueImpl<Item>::begin()
+template <typename Item, typename Tracer, size_t BlockSize>
+BlockQueue<Item, Tracer, BlockSize>::BlockQueue(size_t maxSpareBlocks) : m_maxSpareBlocks{maxSpareBlocks}
 {
-  return Iterator<SingleNode<Item>>(m_left);
 }
 
-template <typename Item>
-Iterator<SingleNode<Item>> QueueImpl<Item>::end()
+template <typename Item, typename Tracer, size_t BlockSize>
+BlockQueue<Item, Tracer, BlockSize>::~BlockQueue()
 {
-  return Iterator<SingleNode<Item>>(nullptr);
+  clear();
+  delete m_head;
+  while (m_spare != nullptr)
+  {
+    delete std::exchange(m_spare, m_spare->next);
+  }
 }
 
-template <typename Item>
-void QueueImpl<Item>::copyNode(SingleNode<Item>* prevLhsNode, SingleNode<Item>* currentRhsNode)
+template <typename Item, typename Tracer, size_t BlockSize>
+auto BlockQueue<Item, Tracer, BlockSize>::acquireBlock() -> Block*
+{
+  if (m_spare == nullptr)
+  {
+    return new Block;
+  }
+  --m_noOfSpare;
+  auto* const block{std::exchange(m_spare, m_spare->next)};
+  block->next = nullptr;
+  return block;
+}
+
+template <typename Item, typename Tracer, size_t BlockSize>
+void BlockQueue<Item, Tracer, BlockSize>::releaseBlock(Block* block)
 {
-  if (currentRhsNode == nullptr)
+  if (m_noOfSpare == m_maxSpareBlocks)
   {
-    m_right = prevLhsNode;
+    delete block;
     return;
   }
+  ++m_noOfSpare;
+  block->next = m_spare;
+  m_spare = block;
+}
 
-  auto* newNode{new SingleNode<Item>{currentRhsNode->item}};
-  prevLhsNode->next = newNode;
-  copyNode(newNode, currentRhsNode->next);
+template <typename Item, typename Tracer, size_t BlockSize>
+void BlockQueue<Item, Tracer, BlockSize>::enqueue(Item item)
+{
+  Tracer::record(this, trace::Event::enqueue);
+  if (m_tail == nullptr)
+  {
+    m_head = m_tail = acquireBlock();
+  }
+  else if (m_tailIndex == BlockSize)
+  {
+    m_tail->next = acquireBlock();
+    m_tail = m_tail->next;
+    m_tailIndex = 0;
+  }
+  std::construct_at(&m_tail->items()[m_tailIndex], std::move(item));
+  ++m_tailIndex;
+  ++m_size;
 }
 
-template <typename Item>
-QueueImpl<Item>::QueueImpl(const QueueImpl<Item>& rhs)
+template <typename Item, typename Tracer, size_t BlockSize>
+void BlockQueue<Item, Tracer, BlockSize>::popFront()
 {
-  fmt::print("QueueImpl<Item>::QueueImpl(const QueueImpl<Item>& rhs) called\n");
-  m_size = rhs.m_size;
+  std::destroy_at(&m_head->items()[m_headIndex]);
+  --m_size;
+  if (++m_headIndex == BlockSize && m_size != 0)
+  {
+    releaseBlock(std::exchange(m_head, m_head->next));
+    m_headIndex = 0;
+  }
+  resetIfEmpty();
+}
 
-  if (isEmpty())
+template <typename Item, typename Tracer, size_t BlockSize>
+void BlockQueue<Item, Tracer, BlockSize>::resetIfEmpty()
+{
+  if (m_size != 0)
   {
     return;
   }
+  // Last item was both front and back
+  assert(m_head == m_tail);
+  m_headIndex = 0;
+  m_tailIndex = 0;
+}
+
+template <typename Item, typename Tracer, size_t BlockSize>
+Item BlockQueue<Item, Tracer, BlockSize>::dequeue()
+{
+  if (isEmpty())
+  {
+    Tracer::record(this, trace::Event::dequeueEmpty);
+    return Item{};
+  }
+  Tracer::record(this, trace::Event::dequeue);
 
-  m_left = new SingleNode<Item>{rhs.m_left->item, rhs.m_left->next};
-  copyNode(m_left, rhs.m_left->next);
+  Item item{std::move(m_head->items()[m_headIndex])};
+  popFront();
+  return item;
 }
 
-template <typename Item>
-std::optional<Item> QueueImpl<Item>::remove(size_t k)
+template <typename Item, typename Tracer, size_t BlockSize>
+std::optional<Item> BlockQueue<Item, Tracer, BlockSize>::remove(size_t k)
 {
-  // If out of range
-  if (k >= size())
+  if (k >= m_size)
   {
     return std::nullopt;
   }
+  Tracer::record(this, trace::Event::remove);
 
-  if (size() == 1 || k == 0)
+  auto position{begin()};
+  if (k < m_size / 2)
   {
-    return {dequeue()};
+    // Rotate [0, k] one step to the back, removed item ends up in carry and the front is popped
+    Item carry{std::move(*position)};
+    for (size_t i{}; i < k; ++i)
+    {
+      std::swap(carry, *++position);
+    }
+    popFront();
+    return {std::move(carry)};
   }
 
-  Iterator<SingleNode<Item>> currentIt{begin()};
-  Iterator<SingleNode<Item>> prevIt{currentIt};
-  for (size_t i{}; i < k; ++i)
+  std::advance(position, k);
+  Item item{std::move(*position)};
+  for (auto next{std::next(position)}; next != end(); position = next++)
   {
-    prevIt = currentIt++;
+    *position = std::move(*next);
   }
 
-  SingleNode<Item>& prevNode{*prevIt};
-  const SingleNode<Item>& currentNode{*currentIt};
-  Item currentNodeItem{currentNode.item};
-
-  prevNode.next = currentNode.next;
-  delete &currentNode;
-
-  if (size() - 1 == k)
+  std::destroy_at(&*position);
+  --m_size;
+  if (--m_tailIndex == 0 && m_head != m_tail)
   {
-    m_right = &prevNode;
+    // Back item was the only one in the tail block
+    auto* beforeTail{m_head};
+    while (beforeTail->next != m_tail)
+    {
+      beforeTail = beforeTail->next;
+    }
+    releaseBlock(std::exchange(m_tail, beforeTail));
+    m_tail->next = nullptr;
+    m_tailIndex = BlockSize;
   }
-  --m_size;
-
-  return {currentNodeItem};
+  resetIfEmpty();
+  return {std::move(item)};
 }
 
-template <typename Item>
-void QueueImpl<Item>::clear()
+template <typename Item, typename Tracer, size_t BlockSize>
+void BlockQueue<Item, Tracer, BlockSize>::clear()
 {
   if (isEmpty())
   {
     return;
   }
+  Tracer::record(this, trace::Event::clear);
 
-  for (SingleNode<Item>* next{}; m_left->next != nullptr;)
+  std::destroy(begin(), end());
+  while (m_head != m_tail)
   {
-    next = m_left->next;
-    delete m_left;
-    m_left = next;
+    releaseBlock(std::exchange(m_head, m_head->next));
   }
-
-  delete m_left;
-  m_left = nullptr;
   m_size = 0;
+  resetIfEmpty();
 }
 
-template <typename Item>
-QueueImpl<Item>::~QueueImpl()
+template <typename Item, typename Tracer, size_t BlockSize>
+[[nodiscard]] inline bool BlockQueue<Item, Tracer, BlockSize>::isEmpty() const
 {
-  clear();
+  return m_size == 0;
 }
 
-template <typename Item>
-Item QueueImpl<Item>::dequeue()
+template <typename Item, typename Tracer, size_t BlockSize>
+[[nodiscard]] inline std::size_t BlockQueue<Item, Tracer, BlockSize>::size() const
 {
-  if (isEmpty())
-  {
-    return Item{};
-  }
+  return m_size;
+}
 
-  --m_size;
+template <typename Item, typename Tracer, size_t BlockSize>
+[[nodiscard]] inline std::size_t BlockQueue<Item, Tracer, BlockSize>::noOfSpareBlocks() const
+{
+  return m_noOfSpare;
+}
 
-  auto* const oldFirst{m_left};
-  m_left = m_left->next;
+// Unbounded MPMC FIFO of Michael and Scott (1996): linked list with a dummy node at the front, producers
+// CAS tail and consumers CAS head, so both ends progress independently and no thread ever blocks.
+// Dequeued nodes are retired through hazard pointers and freed once no other thread can still read them.
+// dequeue() returns Item{} when empty (FifoQueue contract), tryDequeue() tells an empty queue apart.
+template <typename Item, typename Tracer = trace::NoTrace>
+class LockFreeQueue
+{
+  using Node = SingleNode<Item>;
 
-  const Item oldItem{std::move(oldFirst->item)};
-  delete oldFirst;
+public:
+  using value_type = Item;
 
-  return oldItem;
-}
+  LockFreeQueue();
+  LockFreeQueue(const LockFreeQueue&) = delete;
+  LockFreeQueue(LockFreeQueue&&) = delete;
+  LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+  LockFreeQueue& operator=(LockFreeQueue&&) = delete;
+  // No other thread may use the queue any more
+  ~LockFreeQueue();
 
-template <typename Item>
-void QueueImpl<Item>::enqueue(Item item)
-{
-  auto oldLast{m_right};
-  m_right = new SingleNode<Item>{std::move(item)};
+  void enqueue(Item item);
+  Item dequeue();
+  std::optional<Item> tryDequeue();
 
-  ++m_size;
+  [[nodiscard]] bool isEmpty() const;
+  // Approximate when other threads are running
+  [[nodiscard]] std::size_t size() const;
 
-  if (m_left == nullptr)
+private:
+  // Node::next is a plain pointer shared with the single threaded queues, accessed atomically here
+  static std::atomic_ref<Node*> nextOf(Node* node) { return std::atomic_ref<Node*>{node->next}; }
+
+  static_assert(std::atomic_ref<Node*>::is_always_lock_free);
+  static_assert(alignof(Node*) >= std::atomic_ref<Node*>::required_alignment);
+
+  // Dummy node, its item is never read
+  alignas(cacheLineSize) std::atomic<Node*> m_head;
+  alignas(cacheLineSize) std::atomic<Node*> m_tail;
+  // Signed: a dequeue may be counted before the enqueue it took the item from
+  alignas(cacheLineSize) std::atomic<std::ptrdiff_t> m_size{};
+};
+
+template <typename Item, typename Tracer>
+LockFreeQueue<Item, Tracer>::LockFreeQueue() : m_head{new Node{}}, m_tail{m_head.load()}
+{
+}
+
+template <typename Item, typename Tracer>
+LockFreeQueue<Item, Tracer>::~LockFreeQueue()
+{
+  for (auto* node{m_head.load(std::memory_order_acquire)}; node != nullptr;)
   {
-    m_left = m_right;
-    return;
+    delete std::exchange(node, node->next);
   }
-  oldLast->next = m_right;
 }
 
-template <typename Item>
-[[nodiscard]] inline bool QueueImpl<Item>::isEmpty() const
+template <typename Item, typename Tracer>
+void LockFreeQueue<Item, Tracer>::enqueue(Item item)
 {
-  return m_size == 0;
+  Tracer::record(this, trace::Event::enqueue);
+
+  auto* const node{new Node{std::move(item)}};
+  hazard::HazardPointer tailGuard;
+  for (;;)
+  {
+    auto* tail{tailGuard.protect(m_tail)};
+    Node* next{nextOf(tail).load(std::memory_order_acquire)};
+    if (next != nullptr)
+    {
+      // Tail lags behind, help the producer which linked next
+      m_tail.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed);
+      continue;
+    }
+    if (nextOf(tail).compare_exchange_weak(next, node, std::memory_order_release,
+                                           std::memory_order_relaxed))
+    {
+      // Failure means another thread already helped
+      m_tail.compare_exchange_strong(tail, node, std::memory_order_release, std::memory_order_relaxed);
+      break;
+    }
+  }
+  m_size.fetch_add(1, std::memory_order_relaxed);
 }
 
-template <typename Item>
-[[nodiscard]] inline std::size_t QueueImpl<Item>::size() const
+template <typename Item, typename Tracer>
+Item LockFreeQueue<Item, Tracer>::dequeue()
 {
-  return m_size;
+  auto item{tryDequeue()};
+  return item.has_value() ? std::move(*item) : Item{};
 }
 
-// Ex 1.3.35
-template <typename T>
-struct RandomQueue : public QueueImpl<T>
+template <typename Item, typename Tracer>
+std::optional<Item> LockFreeQueue<Item, Tracer>::tryDequeue()
 {
-  using QueueImpl<T>::size;
-  using QueueImpl<T>::begin;
+  hazard::HazardPointer headGuard;
+  hazard::HazardPointer nextGuard;
+  for (;;)
+  {
+    auto* head{headGuard.protect(m_head)};
+    // Safe to read head->next, head is protected
+    auto* const next{nextGuard.protect(nextOf(head))};
+    if (head != m_head.load(std::memory_order_acquire))
+    {
+      continue;
+    }
+    if (next == nullptr)
+    {
+      Tracer::record(this, trace::Event::dequeueEmpty);
+      return std::nullopt;
+    }
 
-  T sample();
-};
+    auto* tail{m_tail.load(std::memory_order_acquire)};
+    if (head == tail)
+    {
+      // Never let head pass tail: tail would point to a retired node
+      m_tail.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed);
+      continue;
+    }
+    if (m_head.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+    {
+      Tracer::record(this, trace::Event::dequeue);
+      // next is the new dummy: only the winner of the CAS touches its item, nextGuard keeps it alive
+      std::optional<Item> item{std::move(next->item)};
+      m_size.fetch_sub(1, std::memory_order_relaxed);
+      headGuard.reset();
+      hazard::retire(head);
+      return item;
+    }
+  }
+}
 
-template <typename T>
-T RandomQueue<T>::sample()
+template <typename Item, typename Tracer>
+[[nodiscard]] inline bool LockFreeQueue<Item, Tracer>::isEmpty() const
 {
-  std::random_device random_device;
-  std::mt19937 random_engine(random_device());
-  std::uniform_int_distribution<size_t> distribution(0, size() - 1);
-
-  const size_t randomNumber = distribution(random_engine);
+  hazard::HazardPointer headGuard;
+  return nextOf(headGuard.protect(m_head)).load(std::memory_order_acquire) == nullptr;
+}
 
-  return (begin() + randomNumber)->item;
+template <typename Item, typename Tracer>
+[[nodiscard]] inline std::size_t LockFreeQueue<Item, Tracer>::size() const
+{
+  return static_cast<std::size_t>(std::max<std::ptrdiff_t>(m_size.load(std::memory_order_relaxed), 0));
 }
 
 }  // namespace queue
@@ -772,7 +4889,7 @@ T RandomQueue<T>::sample()
 namespace efficient_stack
 {
 // Queue of type LIFO
-template <typename Item>
+template <typename Item, typename Tracer = trace::NoTrace>
 class Stack
 {
   using iterator = Item*;
@@ -818,39 +4935,40 @@ private:
   static constexpr int16_t m_extraAllocFactor{2};
 };
 
-template <typename Item>
-std::allocator<Item> Stack<Item>::ms_allocator;
+template <typename Item, typename Tracer>
+std::allocator<Item> Stack<Item, Tracer>::ms_allocator;
 
-template <typename Item>
-std::allocator_traits<decltype(Stack<Item>::ms_allocator)> Stack<Item>::ms_allocatorTraits;
+template <typename Item, typename Tracer>
+std::allocator_traits<decltype(Stack<Item, Tracer>::ms_allocator)>
+    Stack<Item, Tracer>::ms_allocatorTraits;
 
-template <typename Item>
-Stack<Item>::Stack(size_t capacity)
+template <typename Item, typename Tracer>
+Stack<Item, Tracer>::Stack(size_t capacity)
     : m_left{ms_allocatorTraits.allocate(ms_allocator, capacity)},
       m_onePastLast{m_left + capacity},
       m_leftFree{m_left}
 {
 }
 
-template <typename Item>
-Stack<Item>::~Stack()
+template <typename Item, typename Tracer>
+Stack<Item, Tracer>::~Stack()
 {
   free(m_left, m_leftFree, m_onePastLast - m_left);
 }
 
-template <typename Item>
-[[nodiscard]] inline std::ptrdiff_t Stack<Item>::size() const
+template <typename Item, typename Tracer>
+[[nodiscard]] inline std::ptrdiff_t Stack<Item, Tracer>::size() const
 {
   return m_leftFree - m_left;
 }
 
-template <typename Item>
-[[nodiscard]] inline std::ptrdiff_t Stack<Item>::capacity() const
+template <typename Item, typename Tracer>
+[[nodiscard]] inline std::ptrdiff_t Stack<Item, Tracer>::capacity() const
 {
   return m_onePastLast - m_left;
 }
-template <typename Item>
-Item Stack<Item>::peek() const
+template <typename Item, typename Tracer>
+Item Stack<Item, Tracer>::peek() const
 {
   if (isEmpty())
   {
@@ -859,9 +4977,10 @@ Item Stack<Item>::peek() const
   return *(m_leftFree - 1);
 }
 
-template <typename Item>
-void Stack<Item>::push(Item item)
+template <typename Item, typename Tracer>
+void Stack<Item, Tracer>::push(Item item)
 {
+  Tracer::record(this, trace::Event::push);
   if (m_leftFree == m_onePastLast)
   {
     reallocate();
@@ -869,8 +4988,8 @@ void Stack<Item>::push(Item item)
   ms_allocatorTraits.construct(ms_allocator, m_leftFree++, std::move(item));
 }
 
-template <typename Item>
-void Stack<Item>::reallocate()
+template <typename Item, typename Tracer>
+void Stack<Item, Tracer>::reallocate()
 {
   auto* const prevFirstElement{m_left};
   auto* const prevFirstFreeElement{m_leftFree};
@@ -880,8 +4999,8 @@ void Stack<Item>::reallocate()
   free(prevFirstElement, prevFirstFreeElement, noOfElToDeallocate);
 }
 
-template <typename Item>
-void Stack<Item>::allocate(iterator first, iterator firstFree)
+template <typename Item, typename Tracer>
+void Stack<Item, Tracer>::allocate(iterator first, iterator firstFree)
 {
   const size_t newCapacity{calculateNewCapacity()};
   m_left = ms_allocatorTraits.allocate(ms_allocator, newCapacity);
@@ -889,8 +5008,8 @@ void Stack<Item>::allocate(iterator first, iterator firstFree)
   m_leftFree = std::uninitialized_move(first, firstFree, m_left);
 }
 
-template <typename Item>
-void Stack<Item>::free(iterator first, iterator firstFree, std::ptrdiff_t noOfElToDeallocate)
+template <typename Item, typename Tracer>
+void Stack<Item, Tracer>::free(iterator first, iterator firstFree, std::ptrdiff_t noOfElToDeallocate)
 {
   if (firstFree != nullptr)
   {
@@ -902,18 +5021,19 @@ void Stack<Item>::free(iterator first, iterator firstFree, std::ptrdiff_t noOfEl
   }
 }
 
-template <typename Item>
-inline size_t Stack<Item>::calculateNewCapacity()
+template <typename Item, typename Tracer>
+inline size_t Stack<Item, Tracer>::calculateNewCapacity()
 {
   return (capacity() + 1) * m_extraAllocFactor;
 }
 
-template <typename Item>
-Item Stack<Item>::pop()
+template <typename Item, typename Tracer>
+Item Stack<Item, Tracer>::pop()
 {
   Item item{};
   if (m_leftFree != nullptr && m_leftFree != m_left)
   {
+    Tracer::record(this, trace::Event::pop);
     item = *(m_leftFree - 1);
     ms_allocatorTraits.destroy(ms_allocator, --m_leftFree);
     // TODO(damianWu) - reduce capacity
@@ -925,40 +5045,40 @@ Item Stack<Item>::pop()
   return item;
 }
 
-template <typename Item>
-inline bool Stack<Item>::isEmpty() const
+template <typename Item, typename Tracer>
+inline bool Stack<Item, Tracer>::isEmpty() const
 {
   return size() == 0;
 }
 
-template <typename Item>
-inline typename Stack<Item>::iterator Stack<Item>::begin() const
+template <typename Item, typename Tracer>
+inline typename Stack<Item, Tracer>::iterator Stack<Item, Tracer>::begin() const
 {
   return m_left;
 }
 
-template <typename Item>
-inline typename Stack<Item>::iterator Stack<Item>::end() const
+template <typename Item, typename Tracer>
+inline typename Stack<Item, Tracer>::iterator Stack<Item, Tracer>::end() const
 {
   return m_leftFree;
 }
 
 // Points on the first free element
-template <typename Item>
-std::reverse_iterator<typename Stack<Item>::iterator> Stack<Item>::rbegin()
+template <typename Item, typename Tracer>
+std::reverse_iterator<typename Stack<Item, Tracer>::iterator> Stack<Item, Tracer>::rbegin()
 {
-  return std::reverse_iterator<Stack<Item>::iterator>(m_leftFree);
+  return std::reverse_iterator<Stack<Item, Tracer>::iterator>(m_leftFree);
 }
 
 // Points on the first element
-template <typename Item>
-std::reverse_iterator<typename Stack<Item>::iterator> Stack<Item>::rend()
+template <typename Item, typename Tracer>
+std::reverse_iterator<typename Stack<Item, Tracer>::iterator> Stack<Item, Tracer>::rend()
 {
-  return std::reverse_iterator<Stack<Item>::iterator>(m_left);
+  return std::reverse_iterator<Stack<Item, Tracer>::iterator>(m_left);
 }
 
-template <typename Item>
-void Stack<Item>::dump(std::ostream& ostream) const
+template <typename Item, typename Tracer>
+void Stack<Item, Tracer>::dump(std::ostream& ostream) const
 {
   ostream << "m_left=" << m_left << '\n';
   ostream << "m_leftFree=" << m_leftFree << '\n';
@@ -972,7 +5092,8 @@ using it::Iterator;
 using it::SingleNode;
 
 // Queue of type LIFO
-template <typename Item>
+template <typename Item, typename Tracer = trace::NoTrace,
+          template <typename> typename NodeAllocator = it::HeapNodeAllocator>
 class Stack
 {
 public:
@@ -994,65 +5115,279 @@ public:
   Iterator<SingleNode<Item>> begin() const { return Iterator<SingleNode<Item>>{m_left}; }
   Iterator<SingleNode<Item>> end() const { return Iterator<SingleNode<Item>>{nullptr}; }
 
+  // Node transfers between stacks, no allocations. Only for allocators whose nodes may change owner.
+  // Put whole other stack on top of this one keeping its order, O(1)
+  void append(Stack& other)
+    requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable;
+  // Move items below position on top of tail, O(moved items) to keep sizes right
+  void splitAfter(Iterator<SingleNode<Item>> position, Stack& tail)
+    requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable;
+  // Move top count items (all when fewer) on top of other keeping their order, O(count)
+  void moveTopTo(Stack& other, size_t count)
+    requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable;
+
 private:
+  // Put chain first..last (inclusive, last is the lowest) of count nodes on top
+  void linkRun(SingleNode<Item>* first, SingleNode<Item>* last, size_t count);
+
+  [[no_unique_address]] NodeAllocator<SingleNode<Item>> m_nodeAllocator;
   SingleNode<Item>* m_left{};
+  SingleNode<Item>* m_bottom{};
   std::size_t m_size{};
 };
 
-template <typename Item>
-Stack<Item>::~Stack()
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+Stack<Item, Tracer, NodeAllocator>::~Stack()
 {
   clear();
 }
 
-template <typename Item>
-void Stack<Item>::clear()
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void Stack<Item, Tracer, NodeAllocator>::clear()
 {
-  while (!isEmpty())
+  if (isEmpty())
   {
-    pop();
+    return;
   }
+  Tracer::record(this, trace::Event::clear);
+
+  m_nodeAllocator.destroyAll(m_left);
+  m_left = nullptr;
+  m_bottom = nullptr;
+  m_size = 0;
 }
 
-template <typename Item>
-Item Stack<Item>::pop()
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void Stack<Item, Tracer, NodeAllocator>::linkRun(SingleNode<Item>* first, SingleNode<Item>* last,
+                                                 size_t count)
+{
+  last->next = m_left;
+  if (m_left == nullptr)
+  {
+    m_bottom = last;
+  }
+  m_left = first;
+  m_size += count;
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void Stack<Item, Tracer, NodeAllocator>::append(Stack& other)
+  requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable
+{
+  if (other.isEmpty() || &other == this)
+  {
+    return;
+  }
+  Tracer::record(this, trace::Event::splice);
+
+  linkRun(other.m_left, other.m_bottom, other.m_size);
+  other.m_left = nullptr;
+  other.m_bottom = nullptr;
+  other.m_size = 0;
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void Stack<Item, Tracer, NodeAllocator>::splitAfter(Iterator<SingleNode<Item>> position, Stack& tail)
+  requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable
+{
+  auto* const node{position.node()};
+  if (node == nullptr || node->next == nullptr || &tail == this)
+  {
+    return;
+  }
+  Tracer::record(&tail, trace::Event::splice);
+
+  auto* const first{node->next};
+  size_t count{1};
+  for (auto* moved{first}; moved != m_bottom; moved = moved->next)
+  {
+    ++count;
+  }
+
+  node->next = nullptr;
+  tail.linkRun(first, m_bottom, count);
+  m_bottom = node;
+  m_size -= count;
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void Stack<Item, Tracer, NodeAllocator>::moveTopTo(Stack& other, size_t count)
+  requires NodeAllocator<SingleNode<Item>>::nodesAreTransferable
+{
+  if (count == 0 || &other == this || isEmpty())
+  {
+    return;
+  }
+  if (count >= m_size)
+  {
+    other.append(*this);
+    return;
+  }
+  Tracer::record(&other, trace::Event::splice);
+
+  auto* const first{m_left};
+  auto* last{first};
+  for (size_t i{1}; i < count; ++i)
+  {
+    last = last->next;
+  }
+
+  m_left = last->next;
+  m_size -= count;
+  other.linkRun(first, last, count);
+}
+
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+Item Stack<Item, Tracer, NodeAllocator>::pop()
 {
   if (isEmpty())
   {
     return Item();
   }
+  Tracer::record(this, trace::Event::pop);
   --m_size;
 
-  const auto* const oldFirst{m_left};
-  Item oldItem{oldFirst->item};
+  auto* const oldFirst{m_left};
+  Item oldItem{std::move(oldFirst->item)};
 
   m_left = oldFirst->next;
-  delete oldFirst;
+  if (m_left == nullptr)
+  {
+    m_bottom = nullptr;
+  }
+  m_nodeAllocator.destroy(oldFirst);
 
   return oldItem;
 }
 
-template <typename Item>
-void Stack<Item>::push(Item item)
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+void Stack<Item, Tracer, NodeAllocator>::push(Item item)
 {
+  Tracer::record(this, trace::Event::push);
   auto* oldFirst{m_left};
-  m_left = new SingleNode<Item>{std::move(item), oldFirst};
+  m_left = m_nodeAllocator.create(std::move(item), oldFirst);
+  if (oldFirst == nullptr)
+  {
+    m_bottom = m_left;
+  }
 
   ++m_size;
 }
 
-template <typename Item>
-[[nodiscard]] inline bool Stack<Item>::isEmpty() const
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+[[nodiscard]] inline bool Stack<Item, Tracer, NodeAllocator>::isEmpty() const
 {
   return m_size == 0;
 }
-template <typename Item>
-[[nodiscard]] inline std::size_t Stack<Item>::size() const
+template <typename Item, typename Tracer, template <typename> typename NodeAllocator>
+[[nodiscard]] inline std::size_t Stack<Item, Tracer, NodeAllocator>::size() const
 {
   return m_size;
 }
 }  // namespace linked_list_stack
 
+namespace move_to_front
+{
+// Move-to-front stage of a compression pipeline (ex1_3_40 as a codec): every byte is replaced by its
+// position in a list of recently seen bytes and moved to the front, so runs and local repetitions turn
+// into small numbers. Encoder and decoder keep their table between calls, so a stream may be passed in
+// chunks of any size; both sides have to start from the same (reset) state.
+class ByteEncoder
+{
+public:
+  ByteEncoder();
+
+  // output has to hold at least input.size() bytes
+  void encode(std::span<const uint8_t> input, std::span<uint8_t> output);
+  void reset();
+
+private:
+  // Position of byte in the table, searched with SIMD instructions where available
+  [[nodiscard]] size_t find(uint8_t byte) const;
+
+  alignas(cacheLineSize) std::array<uint8_t, 256> m_table{};
+};
+
+class ByteDecoder
+{
+public:
+  ByteDecoder();
+
+  // output has to hold at least input.size() bytes
+  void decode(std::span<const uint8_t> input, std::span<uint8_t> output);
+  void reset();
+
+private:
+  alignas(cacheLineSize) std::array<uint8_t, 256> m_table{};
+};
+
+// Whole file through the byte codec in fixed size chunks, throws std::system_error on I/O failure
+void encodeFile(const std::string& inputPath, const std::string& outputPath);
+void decodeFile(const std::string& inputPath, const std::string& outputPath);
+
+// Symbols 0..alphabetSize-1 ordered by last use with O(log n) rank and select.
+// Every symbol owns a slot on a timeline, the front is the lowest occupied slot and a Fenwick tree
+// counts occupied slots. Moving to front takes a fresh slot below the front; when the timeline runs out
+// the symbols are renumbered in O(n), which happens once per alphabetSize moves.
+class RankList
+{
+public:
+  explicit RankList(size_t alphabetSize);
+
+  [[nodiscard]] size_t alphabetSize() const;
+  // Number of symbols in front of symbol
+  [[nodiscard]] uint32_t rankOf(uint32_t symbol) const;
+  // Symbol with rank symbols in front of it
+  [[nodiscard]] uint32_t symbolAt(uint32_t rank) const;
+  void moveToFront(uint32_t symbol);
+  void reset();
+
+private:
+  void add(size_t slot, int32_t delta);
+  void renumber();
+  void buildTree();
+
+  const size_t m_alphabetSize{};
+  // Slots on the timeline, symbols take alphabetSize of them
+  const size_t m_noOfSlots{};
+  std::vector<uint32_t> m_slotOf;
+  std::vector<uint32_t> m_symbolIn;
+  // Fenwick tree (1-based) of occupied slots
+  std::vector<uint32_t> m_tree;
+  size_t m_front{};
+};
+
+// Move-to-front over a large alphabet (words, 16-bit symbols...), O(log n) per symbol.
+// Throws std::out_of_range for symbols and ranks outside of the alphabet.
+class AlphabetEncoder
+{
+public:
+  explicit AlphabetEncoder(size_t alphabetSize);
+
+  [[nodiscard]] uint32_t encode(uint32_t symbol);
+  // output has to hold at least input.size() ranks
+  void encode(std::span<const uint32_t> input, std::span<uint32_t> output);
+  void reset();
+
+private:
+  RankList m_list;
+};
+
+class AlphabetDecoder
+{
+public:
+  explicit AlphabetDecoder(size_t alphabetSize);
+
+  [[nodiscard]] uint32_t decode(uint32_t rank);
+  // output has to hold at least input.size() symbols
+  void decode(std::span<const uint32_t> input, std::span<uint32_t> output);
+  void reset();
+
+private:
+  RankList m_list;
+};
+}  // namespace move_to_front
+
 namespace homework
 {
 bool ex1_3_5(std::string_view input);
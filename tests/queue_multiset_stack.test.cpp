@@ -1,16 +1,31 @@
 // Copyright [2024] <@damianWu>
 
 #include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <fstream>
 #include <iterator>
+#include <numeric>
 #include <optional>
+#include <random>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "ch1/ch1.hpp"
@@ -18,6 +33,105 @@
 namespace ch1
 {
 using size_t = std::size_t;
+namespace trace
+{
+TEST(TraceTest, bufferTraceShouldRecordContainerEventsInOrder)
+{
+  auto& traceBuffer{TraceBuffer::instance()};
+  traceBuffer.clear();
+
+  cyclic_buffer::RingBuffer<int32_t, BufferTrace> ringBuffer{1};
+  ringBuffer.enqueue(1);
+  ringBuffer.enqueue(2);
+  std::ignore = ringBuffer.dequeue();
+  std::ignore = ringBuffer.dequeue();
+
+  const std::array expectedEvents{Event::enqueue, Event::enqueueRejected, Event::dequeue,
+                                  Event::dequeueEmpty};
+  ASSERT_EQ(expectedEvents.size(), traceBuffer.size());
+  for (size_t i{}; i < expectedEvents.size(); ++i)
+  {
+    ASSERT_EQ(expectedEvents[i], traceBuffer[i].event);
+    ASSERT_EQ(&ringBuffer, traceBuffer[i].container);
+  }
+
+  std::ostringstream dump;
+  traceBuffer.dump(dump);
+  ASSERT_NE(std::string::npos, dump.str().find("enqueueRejected"));
+  traceBuffer.clear();
+}
+
+TEST(TraceTest, traceBufferShouldKeepOnlyNewestRecordsAfterWrap)
+{
+  auto& traceBuffer{TraceBuffer::instance()};
+  traceBuffer.clear();
+
+  queue::QueueImpl<int32_t, BufferTrace> queue;
+  for (size_t i{}; i < TraceBuffer::capacity; ++i)
+  {
+    queue.enqueue(1);
+  }
+  queue.dequeue();
+
+  ASSERT_EQ(TraceBuffer::capacity, traceBuffer.size());
+  ASSERT_EQ(TraceBuffer::capacity + 1, traceBuffer.noOfRecorded());
+  ASSERT_EQ(Event::dequeue, traceBuffer[TraceBuffer::capacity - 1].event);
+  traceBuffer.clear();
+}
+
+}  // namespace trace
+
+namespace it
+{
+TEST(PoolNodeAllocatorTest, destroyedNodeSlotShouldBeReused)
+{
+  PoolNodeAllocator<SingleNode<std::string>> allocator;
+  auto* const first{allocator.create("first")};
+  auto* const second{allocator.create("second", first)};
+  ASSERT_EQ("first", second->next->item);
+
+  allocator.destroy(first);
+  auto* const third{allocator.create("third")};
+  ASSERT_EQ(first, third);
+
+  second->next = third;
+  allocator.destroyAll(second);
+}
+
+TEST(PoolNodeAllocatorTest, destroyAllShouldReleaseNodesSpanningManySlabs)
+{
+  PoolNodeAllocator<DoubleNode<std::string>> allocator;
+  constexpr int32_t noOfNodes{10'000};
+
+  DoubleNode<std::string>* first{};
+  for (int32_t i{}; i < noOfNodes; ++i)
+  {
+    first = allocator.create(std::to_string(i), first);
+  }
+  int32_t expected{noOfNodes};
+  for (auto* node{first}; node != nullptr; node = node->next)
+  {
+    ASSERT_EQ(std::to_string(--expected), node->item);
+  }
+
+  allocator.destroyAll(first);
+  auto* const node{allocator.create("after release")};
+  ASSERT_EQ("after release", node->item);
+  allocator.destroyAll(node);
+}
+
+TEST(PoolNodeAllocatorTest, emptyDefaultAllocatorShouldTakeNoSpace)
+{
+  static_assert(sizeof(double_linked_list::DoubleLinkedList<int32_t>) ==
+                2 * sizeof(void*) + sizeof(size_t));
+  static_assert(sizeof(queue::QueueImpl<int32_t>) == 2 * sizeof(void*) + sizeof(size_t));
+  static_assert(sizeof(linked_list_stack::Stack<int32_t>) == 2 * sizeof(void*) + sizeof(size_t));
+  static_assert(sizeof(queue::QueueImpl<int32_t>) <
+                sizeof(queue::QueueImpl<int32_t, trace::NoTrace, PoolNodeAllocator>));
+}
+
+}  // namespace it
+
 namespace cyclic_buffer
 {
 
@@ -70,11 +184,721 @@ TEST(RingBufferDequeueTest, shouldHaveValidFullAndEmptyStateAfterDequeue)
   cyclicBuffer.enqueue("item7");
   cyclicBuffer.enqueue("item8");
 
-  ASSERT_EQ("item7", *std::begin(cyclicBuffer));
-  ASSERT_EQ("item8", *(std::begin(cyclicBuffer) + 1));
+  ASSERT_EQ("item4", *std::begin(cyclicBuffer));
+  ASSERT_EQ("item7", *std::next(std::begin(cyclicBuffer), 3));
+  ASSERT_EQ("item8", *std::next(std::begin(cyclicBuffer), 4));
   ASSERT_EQ(5u, cyclicBuffer.size());
 }
 
+TEST(RingBufferBulkTest, enqueueBulkShouldCopyOnlyItemsThatFit)
+{
+  RingBuffer<int32_t> ringBuffer{4};
+  const std::array<int32_t, 6> items{1, 2, 3, 4, 5, 6};
+
+  ASSERT_EQ(4u, ringBuffer.enqueueBulk(items));
+  ASSERT_TRUE(ringBuffer.isFull());
+  ASSERT_EQ(0u, ringBuffer.enqueueBulk(items));
+  ASSERT_EQ(4u, ringBuffer.size());
+}
+
+TEST(RingBufferBulkTest, bulkTransferShouldSplitAtWrapPoint)
+{
+  RingBuffer<int32_t> ringBuffer{5};
+  const std::array<int32_t, 3> firstBatch{1, 2, 3};
+  const std::array<int32_t, 4> secondBatch{4, 5, 6, 7};
+  std::array<int32_t, 2> head{};
+  std::array<int32_t, 8> rest{};
+
+  ASSERT_EQ(3u, ringBuffer.enqueueBulk(firstBatch));
+  ASSERT_EQ(2u, ringBuffer.dequeueBulk(head));
+  ASSERT_EQ(4u, ringBuffer.enqueueBulk(secondBatch));
+  ASSERT_TRUE(ringBuffer.isFull());
+
+  ASSERT_EQ(5u, ringBuffer.dequeueBulk(rest));
+  ASSERT_TRUE(ringBuffer.isEmpty());
+
+  ASSERT_EQ((std::array<int32_t, 2>{1, 2}), head);
+  ASSERT_TRUE(std::ranges::equal(std::span{rest}.first(5), std::array<int32_t, 5>{3, 4, 5, 6, 7}));
+}
+
+TEST(RingBufferBulkTest, bulkTransferShouldWorkForNonTriviallyCopyableItems)
+{
+  RingBuffer<std::string> ringBuffer{3};
+  const std::vector<std::string> items{"item1", "item2", "item3"};
+  std::vector<std::string> output(2);
+
+  ASSERT_EQ(3u, ringBuffer.enqueueBulk(items));
+  ASSERT_EQ(2u, ringBuffer.dequeueBulk(output));
+  ASSERT_EQ(1u, ringBuffer.enqueueBulk(std::span{items}.first(1)));
+
+  ASSERT_EQ((std::vector<std::string>{"item1", "item2"}), output);
+  ASSERT_EQ(2u, ringBuffer.dequeueBulk(output));
+  ASSERT_EQ((std::vector<std::string>{"item3", "item1"}), output);
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(LossyRingBufferTest, enqueueOnFullBufferShouldOverwriteOldestItem)
+{
+  LossyRingBuffer<std::string> ringBuffer{3};
+
+  for (size_t i{}; i < 5; ++i)
+  {
+    ASSERT_TRUE(ringBuffer.enqueue("item" + std::to_string(i)));
+  }
+
+  ASSERT_TRUE(ringBuffer.isFull());
+  ASSERT_EQ(2u, ringBuffer.noOfDropped());
+  ASSERT_EQ(ringBuffer.dequeue(), "item2");
+  ASSERT_EQ(ringBuffer.dequeue(), "item3");
+  ASSERT_EQ(ringBuffer.dequeue(), "item4");
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(LossyRingBufferTest, enqueueBulkShouldKeepNewestItems)
+{
+  LossyRingBuffer<int32_t> ringBuffer{4};
+  const std::array<int32_t, 3> firstBatch{1, 2, 3};
+  const std::array<int32_t, 6> secondBatch{4, 5, 6, 7, 8, 9};
+  std::array<int32_t, 4> output{};
+
+  ASSERT_EQ(3u, ringBuffer.enqueueBulk(firstBatch));
+  ASSERT_EQ(2u, ringBuffer.enqueueBulk(std::span{secondBatch}.first(2)));
+  ASSERT_EQ(1u, ringBuffer.noOfDropped());
+
+  ASSERT_EQ(4u, ringBuffer.enqueueBulk(secondBatch));
+  ASSERT_EQ(1u + 4u + 2u, ringBuffer.noOfDropped());
+
+  ASSERT_EQ(4u, ringBuffer.dequeueBulk(output));
+  ASSERT_EQ((std::array<int32_t, 4>{6, 7, 8, 9}), output);
+}
+
+TEST(LossyRingBufferTest, defaultPolicyShouldRejectAndNotDrop)
+{
+  RingBuffer<int32_t> ringBuffer{1};
+
+  ASSERT_TRUE(ringBuffer.enqueue(1));
+  ASSERT_FALSE(ringBuffer.enqueue(2));
+  ASSERT_EQ(0u, ringBuffer.noOfDropped());
+  ASSERT_EQ(ringBuffer.dequeue(), 1);
+}
+
+struct Message
+{
+  Message() = default;
+  Message(int32_t newId, std::string newPayload) : id{newId}, payload{std::move(newPayload)} {}
+  Message(const Message&) = delete;
+  Message(Message&&) = delete;
+  Message& operator=(const Message&) = delete;
+  Message& operator=(Message&&) = delete;
+  ~Message() = default;
+
+  int32_t id{};
+  std::string payload;
+};
+
+TEST(RingBufferZeroCopyTest, reserveCommitPeekReleaseShouldNeverCopyOrMoveItems)
+{
+  RingBuffer<Message> ringBuffer{2};
+
+  auto* const first{ringBuffer.reserve(1, "payload1")};
+  ASSERT_NE(nullptr, first);
+  ringBuffer.commit();
+
+  auto* const second{ringBuffer.reserve()};
+  second->id = 2;
+  second->payload = "payload2";
+  ringBuffer.commit();
+
+  ASSERT_TRUE(ringBuffer.isFull());
+  ASSERT_EQ(nullptr, ringBuffer.reserve());
+
+  ASSERT_EQ(first, ringBuffer.peek());
+  ASSERT_EQ("payload1", ringBuffer.peek()->payload);
+  ringBuffer.release();
+  ASSERT_EQ(2, ringBuffer.peek()->id);
+  ringBuffer.release();
+
+  ASSERT_EQ(nullptr, ringBuffer.peek());
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(RingBufferZeroCopyTest, reserveOnFullLossyBufferShouldDropOldestItem)
+{
+  LossyRingBuffer<std::string> ringBuffer{2};
+
+  ringBuffer.enqueue("item1");
+  ringBuffer.enqueue("item2");
+  *ringBuffer.reserve() = "item3";
+  ringBuffer.commit();
+
+  ASSERT_EQ(1u, ringBuffer.noOfDropped());
+  ASSERT_EQ("item2", *ringBuffer.peek());
+  ASSERT_EQ(ringBuffer.dequeue(), "item2");
+  ASSERT_EQ(ringBuffer.dequeue(), "item3");
+}
+
+// Counts alive instances, has no default constructor
+struct LiveCounted
+{
+  explicit LiveCounted(int32_t newValue) : value{newValue} { ++noOfAlive; }
+  LiveCounted(const LiveCounted& rhs) : value{rhs.value} { ++noOfAlive; }
+  LiveCounted(LiveCounted&& rhs) noexcept : value{rhs.value} { ++noOfAlive; }
+  LiveCounted& operator=(const LiveCounted&) = default;
+  LiveCounted& operator=(LiveCounted&&) = default;
+  ~LiveCounted() { --noOfAlive; }
+
+  static inline int32_t noOfAlive{};
+  int32_t value{};
+};
+
+TEST(RingBufferStorageTest, onlyQueuedItemsShouldBeAlive)
+{
+  {
+    RingBuffer<LiveCounted> ringBuffer{8};
+    ASSERT_EQ(0, LiveCounted::noOfAlive);
+
+    ringBuffer.enqueue(LiveCounted{1});
+    ringBuffer.enqueue(LiveCounted{2});
+    std::ignore = ringBuffer.reserve(3);
+    ringBuffer.commit();
+    ASSERT_EQ(3, LiveCounted::noOfAlive);
+
+    const auto item{ringBuffer.dequeue()};
+    ASSERT_EQ(1, item->value);
+    ASSERT_EQ(3, LiveCounted::noOfAlive);
+
+    ringBuffer.release();
+    ASSERT_EQ(2, LiveCounted::noOfAlive);
+  }
+  ASSERT_EQ(0, LiveCounted::noOfAlive);
+}
+
+TEST(RingBufferStorageTest, iterationShouldVisitOnlyQueuedItemsAcrossWrapPoint)
+{
+  static_assert(std::forward_iterator<RingBuffer<std::string>::ItemIterator>);
+
+  RingBuffer<std::string> ringBuffer{4};
+  ASSERT_EQ(ringBuffer.begin(), ringBuffer.end());
+
+  for (const auto* item : {"a", "b", "c"})
+  {
+    ringBuffer.enqueue(item);
+  }
+  std::ignore = ringBuffer.dequeue();
+  std::ignore = ringBuffer.dequeue();
+  ringBuffer.enqueue("d");
+  ringBuffer.enqueue("e");
+  *ringBuffer.reserve() = "reserved";
+
+  ASSERT_EQ((std::vector<std::string>{"c", "d", "e"}),
+            (std::vector<std::string>{ringBuffer.begin(), ringBuffer.end()}));
+  ringBuffer.commit();
+  for (auto& item : ringBuffer)
+  {
+    item += "'";
+  }
+  ASSERT_EQ(ringBuffer.dequeue(), "c'");
+  ASSERT_EQ("reserved'", *std::next(ringBuffer.begin(), 2));
+}
+
+TEST(RingBufferStorageTest, reservedButNotCommittedItemShouldBeDestroyed)
+{
+  {
+    RingBuffer<LiveCounted> ringBuffer{2};
+    ringBuffer.enqueue(LiveCounted{1});
+    std::ignore = ringBuffer.reserve(2);
+    ASSERT_EQ(2, LiveCounted::noOfAlive);
+    ASSERT_EQ(1u, ringBuffer.size());
+  }
+  ASSERT_EQ(0, LiveCounted::noOfAlive);
+}
+
+TEST(RingBufferStorageTest, reserveTwiceWithoutCommitShouldAssert)
+{
+  RingBuffer<std::string> ringBuffer{4};
+  *ringBuffer.reserve() = "item1";
+  EXPECT_DEBUG_DEATH(std::ignore = ringBuffer.reserve(), "not committed");
+  ringBuffer.commit();
+  ASSERT_NE(nullptr, ringBuffer.reserve());
+  ringBuffer.commit();
+  ASSERT_EQ(2u, ringBuffer.size());
+}
+
+TEST(RingBufferStorageTest, droppedAndBulkDequeuedItemsShouldBeDestroyed)
+{
+  {
+    LossyRingBuffer<LiveCounted> ringBuffer{2};
+    for (int32_t i{}; i < 5; ++i)
+    {
+      ringBuffer.enqueue(LiveCounted{i});
+    }
+    ASSERT_EQ(2, LiveCounted::noOfAlive);
+
+    std::vector<LiveCounted> output{LiveCounted{0}};
+    ASSERT_EQ(1u, ringBuffer.dequeueBulk(output));
+    ASSERT_EQ(3, output.front().value);
+    ASSERT_EQ(2, LiveCounted::noOfAlive);
+  }
+  ASSERT_EQ(0, LiveCounted::noOfAlive);
+}
+
+TEST(StaticRingBufferTest, shouldBeUsableInConstantExpressions)
+{
+  constexpr auto dequeuedSum{[]
+                             {
+                               StaticRingBuffer<int32_t, 4> ringBuffer;
+                               for (int32_t i{1}; i <= 5; ++i)
+                               {
+                                 ringBuffer.enqueue(i);
+                               }
+                               int32_t sum{*ringBuffer.dequeue() + *ringBuffer.dequeue()};
+                               ringBuffer.enqueue(10);
+                               while (const auto item{ringBuffer.dequeue()})
+                               {
+                                 sum += *item;
+                               }
+                               return sum;
+                             }()};
+
+  static_assert(dequeuedSum == 1 + 2 + 3 + 4 + 10);
+  static_assert(sizeof(StaticRingBuffer<int32_t, 4>) == 4 * sizeof(int32_t) + 2 * sizeof(size_t));
+}
+
+TEST(StaticRingBufferTest, shouldKeepFifoOrderAfterWrap)
+{
+  StaticRingBuffer<std::string, 2> ringBuffer;
+
+  ASSERT_TRUE(ringBuffer.enqueue("item1"));
+  ASSERT_TRUE(ringBuffer.enqueue("item2"));
+  ASSERT_FALSE(ringBuffer.enqueue("item3"));
+  ASSERT_TRUE(ringBuffer.isFull());
+
+  ASSERT_EQ(ringBuffer.dequeue(), "item1");
+  ASSERT_TRUE(ringBuffer.enqueue("item3"));
+  ASSERT_EQ(ringBuffer.dequeue(), "item2");
+  ASSERT_EQ(ringBuffer.dequeue(), "item3");
+  ASSERT_EQ(ringBuffer.dequeue(), std::nullopt);
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(SpscRingBufferTest, capacityShouldBeRoundedUpToPowerOfTwo)
+{
+  SpscRingBuffer<int32_t> ringBuffer{6};
+
+  ASSERT_EQ(8u, ringBuffer.capacity());
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(SpscRingBufferTest, shouldRejectEnqueueWhenFullAndKeepFifoOrderAfterWrap)
+{
+  SpscRingBuffer<std::string> ringBuffer{4};
+
+  for (size_t i{}; i < ringBuffer.capacity(); ++i)
+  {
+    ASSERT_TRUE(ringBuffer.enqueue("item" + std::to_string(i)));
+  }
+  ASSERT_TRUE(ringBuffer.isFull());
+  ASSERT_FALSE(ringBuffer.enqueue("item4"));
+
+  ASSERT_EQ(ringBuffer.dequeue(), "item0");
+  ASSERT_EQ(ringBuffer.dequeue(), "item1");
+  ASSERT_TRUE(ringBuffer.enqueue("item4"));
+  ASSERT_TRUE(ringBuffer.enqueue("item5"));
+
+  ASSERT_EQ(ringBuffer.dequeue(), "item2");
+  ASSERT_EQ(ringBuffer.dequeue(), "item3");
+  ASSERT_EQ(ringBuffer.dequeue(), "item4");
+  ASSERT_EQ(ringBuffer.dequeue(), "item5");
+  ASSERT_EQ(ringBuffer.dequeue(), std::nullopt);
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(SpscRingBufferTest, consumerThreadShouldReceiveAllItemsInOrder)
+{
+  constexpr uint64_t noOfItems{200'000};
+  SpscRingBuffer<uint64_t> ringBuffer{64};
+
+  std::thread producer{[&ringBuffer]
+                       {
+                         for (uint64_t i{}; i < noOfItems; ++i)
+                         {
+                           while (!ringBuffer.enqueue(i))
+                           {
+                             std::this_thread::yield();
+                           }
+                         }
+                       }};
+
+  uint64_t expected{};
+  while (expected < noOfItems)
+  {
+    if (const auto item{ringBuffer.dequeue()})
+    {
+      ASSERT_EQ(expected, *item);
+      ++expected;
+      continue;
+    }
+    std::this_thread::yield();
+  }
+  producer.join();
+
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(MpmcRingBufferTest, shouldRejectEnqueueWhenFullAndRejectDequeueWhenEmpty)
+{
+  MpmcRingBuffer<std::string> ringBuffer{3};
+
+  ASSERT_EQ(4u, ringBuffer.capacity());
+  ASSERT_EQ(ringBuffer.dequeue(), std::nullopt);
+
+  for (size_t i{}; i < ringBuffer.capacity(); ++i)
+  {
+    ASSERT_TRUE(ringBuffer.enqueue("item" + std::to_string(i)));
+  }
+  ASSERT_TRUE(ringBuffer.isFull());
+  ASSERT_FALSE(ringBuffer.enqueue("item4"));
+
+  for (size_t i{}; i < ringBuffer.capacity(); ++i)
+  {
+    ASSERT_EQ(ringBuffer.dequeue(), "item" + std::to_string(i));
+  }
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(MpmcRingBufferTest, everyItemShouldBeReceivedExactlyOnceByManyConsumers)
+{
+  constexpr size_t noOfProducers{4};
+  constexpr size_t noOfConsumers{4};
+  constexpr uint64_t noOfItemsPerProducer{20'000};
+  constexpr uint64_t noOfItems{noOfProducers * noOfItemsPerProducer};
+
+  MpmcRingBuffer<uint64_t> ringBuffer{64};
+  std::vector<std::atomic<uint32_t>> received(noOfItems);
+  std::atomic<uint64_t> noOfReceived{};
+
+  std::vector<std::thread> threads;
+  for (size_t p{}; p < noOfProducers; ++p)
+  {
+    threads.emplace_back(
+        [&ringBuffer, p]
+        {
+          for (uint64_t i{p * noOfItemsPerProducer}; i < (p + 1) * noOfItemsPerProducer; ++i)
+          {
+            while (!ringBuffer.enqueue(i))
+            {
+              std::this_thread::yield();
+            }
+          }
+        });
+  }
+  for (size_t c{}; c < noOfConsumers; ++c)
+  {
+    threads.emplace_back(
+        [&]
+        {
+          while (noOfReceived.load() < noOfItems)
+          {
+            if (const auto item{ringBuffer.dequeue()})
+            {
+              received[*item].fetch_add(1);
+              noOfReceived.fetch_add(1);
+              continue;
+            }
+            std::this_thread::yield();
+          }
+        });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  ASSERT_TRUE(std::ranges::all_of(received, [](const auto& count) { return count.load() == 1; }));
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+template <typename WaitStrategy>
+struct RingBufferWaitTest : public testing::Test
+{
+};
+
+using WaitStrategies = testing::Types<wait::BusySpin, wait::Yield, wait::SpinThenPark, wait::Park>;
+TYPED_TEST_SUITE(RingBufferWaitTest, WaitStrategies);
+
+TYPED_TEST(RingBufferWaitTest, dequeueWaitShouldReturnItemsEnqueuedLaterByProducer)
+{
+  constexpr uint64_t noOfItems{2'000};
+  BlockingSpscRingBuffer<uint64_t> ringBuffer{16};
+
+  std::thread producer{[&ringBuffer]
+                       {
+                         for (uint64_t i{}; i < noOfItems; ++i)
+                         {
+                           while (!ringBuffer.enqueue(i))
+                           {
+                             std::this_thread::yield();
+                           }
+                         }
+                       }};
+
+  for (uint64_t i{}; i < noOfItems; ++i)
+  {
+    ASSERT_EQ(i, ringBuffer.template dequeueWait<TypeParam>());
+  }
+  producer.join();
+}
+
+TYPED_TEST(RingBufferWaitTest, dequeueForShouldTimeOutWhenNothingArrives)
+{
+  BlockingMpmcRingBuffer<int32_t> ringBuffer{4};
+
+  const auto start{std::chrono::steady_clock::now()};
+  const auto item{ringBuffer.template dequeueFor<TypeParam>(std::chrono::milliseconds{20})};
+
+  ASSERT_EQ(std::nullopt, item);
+  ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{20});
+}
+
+TEST(RingBufferWaitTest, parkedConsumersShouldAllBeWokenByProducers)
+{
+  constexpr size_t noOfConsumers{3};
+  constexpr int32_t itemsPerConsumer{100};
+  BlockingMpmcRingBuffer<int32_t> ringBuffer{8};
+  std::atomic<int32_t> sum{};
+
+  std::vector<std::thread> consumers;
+  for (size_t c{}; c < noOfConsumers; ++c)
+  {
+    consumers.emplace_back(
+        [&]
+        {
+          for (int32_t i{}; i < itemsPerConsumer; ++i)
+          {
+            sum += ringBuffer.dequeueWait<wait::Park>();
+          }
+        });
+  }
+
+  for (int32_t i{}; i < static_cast<int32_t>(noOfConsumers) * itemsPerConsumer; ++i)
+  {
+    while (!ringBuffer.enqueue(1))
+    {
+      std::this_thread::yield();
+    }
+  }
+  for (auto& consumer : consumers)
+  {
+    consumer.join();
+  }
+
+  ASSERT_EQ(static_cast<int32_t>(noOfConsumers) * itemsPerConsumer, sum.load());
+}
+
+TEST(RingBufferWaitTest, nonBlockingRingShouldWaitWithoutNotifier)
+{
+  // Default policy keeps no notifier and enqueue does not look for sleepers
+  static_assert(sizeof(SpscRingBuffer<int32_t>) < sizeof(BlockingSpscRingBuffer<int32_t>));
+  static_assert(std::is_same_v<wait::Yield, wait::DefaultStrategy<wait::NoNotifier>>);
+
+  SpscRingBuffer<int32_t> ringBuffer{4};
+  std::thread producer{[&ringBuffer]
+                       {
+                         std::this_thread::sleep_for(std::chrono::milliseconds{5});
+                         ringBuffer.enqueue(7);
+                       }};
+  ASSERT_EQ(7, ringBuffer.dequeueWait());
+  ASSERT_EQ(std::nullopt, ringBuffer.dequeueFor<wait::BusySpin>(std::chrono::milliseconds{1}));
+  producer.join();
+}
+
+TEST(RingBufferWaitTest, spinThenParkShouldAdaptSpinLimitToRecentWaits)
+{
+  auto& limit{wait::SpinThenPark::spinLimit()};
+  const auto initialLimit{limit};
+
+  // Items keep arriving after about 4000 spins, limit grows towards twice that
+  for (int32_t i{}; i < 50; ++i)
+  {
+    wait::SpinThenPark::onWaitEnd(4'000, false);
+  }
+  ASSERT_GT(limit, 7'000u);
+  ASSERT_LE(limit, 8'000u);
+
+  // Parking anyway, spinning does not pay off
+  for (int32_t i{}; i < 100; ++i)
+  {
+    wait::SpinThenPark::onWaitEnd(limit, true);
+  }
+  ASSERT_EQ(wait::SpinThenPark::minSpinLimit, limit);
+
+  limit = initialLimit;
+}
+
+struct SharedMemoryRingBufferTest : public testing::Test
+{
+  const std::string name{"/ch1_test_ring_" + std::to_string(getpid())};
+};
+
+TEST_F(SharedMemoryRingBufferTest, openedRingShouldSeeItemsOfCreatedRing)
+{
+  auto producer{SharedMemoryRingBuffer<int64_t>::create(name, 3)};
+  auto consumer{SharedMemoryRingBuffer<int64_t>::open(name)};
+
+  ASSERT_EQ(4u, consumer.capacity());
+  for (int64_t i{}; i < 4; ++i)
+  {
+    ASSERT_TRUE(producer.enqueue(i));
+  }
+  ASSERT_FALSE(producer.enqueue(4));
+  ASSERT_TRUE(consumer.isFull());
+
+  for (int64_t i{}; i < 4; ++i)
+  {
+    ASSERT_EQ(consumer.dequeue(), i);
+  }
+  ASSERT_EQ(consumer.dequeue(), std::nullopt);
+}
+
+TEST_F(SharedMemoryRingBufferTest, openShouldFailForMissingRegionOrDifferentItemType)
+{
+  ASSERT_THROW(SharedMemoryRingBuffer<int64_t>::open(name), std::system_error);
+
+  const auto ring{SharedMemoryRingBuffer<int64_t>::create(name, 4)};
+  ASSERT_THROW(SharedMemoryRingBuffer<int32_t>::open(name), std::runtime_error);
+}
+
+TEST_F(SharedMemoryRingBufferTest, openShouldRejectCapacityCorruptedByOtherProcess)
+{
+  const auto ring{SharedMemoryRingBuffer<int64_t>::create(name, 4)};
+  // Header starts with magic, then capacity
+  auto raw{SharedMemory::open(name)};
+  auto* const capacity{reinterpret_cast<uint64_t*>(raw.data() + sizeof(uint64_t))};
+
+  for (const uint64_t corrupted : {uint64_t{0}, uint64_t{3}, uint64_t{1} << 62, uint64_t{1} << 20})
+  {
+    *capacity = corrupted;
+    ASSERT_THROW(SharedMemoryRingBuffer<int64_t>::open(name), std::runtime_error) << corrupted;
+  }
+  *capacity = 4;
+  ASSERT_EQ(4u, SharedMemoryRingBuffer<int64_t>::open(name).capacity());
+}
+
+TEST_F(SharedMemoryRingBufferTest, reopenedRingShouldContinueFromCurrentCursors)
+{
+  auto ring{SharedMemoryRingBuffer<int64_t>::create(name, 4)};
+  for (int64_t i{}; i < 5; ++i)
+  {
+    ASSERT_TRUE(ring.enqueue(i));
+    if (i < 3)
+    {
+      ASSERT_EQ(ring.dequeue(), i);
+    }
+  }
+
+  // Two items queued, the opened handle must neither overwrite nor read past them
+  auto producer{SharedMemoryRingBuffer<int64_t>::open(name)};
+  ASSERT_TRUE(producer.enqueue(5));
+  ASSERT_TRUE(producer.enqueue(6));
+  ASSERT_FALSE(producer.enqueue(7));
+
+  auto consumer{SharedMemoryRingBuffer<int64_t>::open(name)};
+  for (int64_t i{3}; i < 7; ++i)
+  {
+    ASSERT_EQ(consumer.dequeue(), i);
+  }
+  ASSERT_EQ(consumer.dequeue(), std::nullopt);
+  ASSERT_TRUE(consumer.isEmpty());
+}
+
+TEST_F(SharedMemoryRingBufferTest, childProcessShouldReceiveAllItemsInOrder)
+{
+  constexpr uint64_t noOfItems{100'000};
+  auto producer{SharedMemoryRingBuffer<uint64_t>::create(name, 256)};
+
+  const pid_t child{fork()};
+  ASSERT_NE(-1, child);
+  if (child == 0)
+  {
+    auto consumer{SharedMemoryRingBuffer<uint64_t>::open(name)};
+    for (uint64_t expected{}; expected < noOfItems;)
+    {
+      if (const auto item{consumer.dequeue()})
+      {
+        if (*item != expected++)
+        {
+          _exit(1);
+        }
+        continue;
+      }
+      std::this_thread::yield();
+    }
+    _exit(0);
+  }
+
+  for (uint64_t i{}; i < noOfItems; ++i)
+  {
+    while (!producer.enqueue(i))
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  int status{};
+  ASSERT_EQ(child, waitpid(child, &status, 0));
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(0, WEXITSTATUS(status));
+}
+
+TEST(MirroredByteRingBufferTest, capacityShouldBeRoundedUpToPageSize)
+{
+  const MirroredByteRingBuffer ringBuffer{100};
+
+  ASSERT_EQ(static_cast<size_t>(sysconf(_SC_PAGESIZE)), ringBuffer.capacity());
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(MirroredByteRingBufferTest, readableWindowCrossingWrapPointShouldBeContiguous)
+{
+  MirroredByteRingBuffer ringBuffer{1};
+  const size_t capacity{ringBuffer.capacity()};
+  std::vector<std::byte> bytes(capacity - 2, std::byte{0xAA});
+
+  ASSERT_EQ(bytes.size(), ringBuffer.write(bytes));
+  ringBuffer.consume(bytes.size());
+
+  // Writable window starts 2 bytes before the end of the buffer and still spans whole capacity
+  auto writable{ringBuffer.writable()};
+  ASSERT_EQ(capacity, writable.size());
+  for (size_t i{}; i < 6; ++i)
+  {
+    writable[i] = static_cast<std::byte>(i);
+  }
+  ringBuffer.commit(6);
+
+  const auto readable{ringBuffer.readable()};
+  ASSERT_EQ(6u, readable.size());
+  for (size_t i{}; i < readable.size(); ++i)
+  {
+    ASSERT_EQ(static_cast<std::byte>(i), readable[i]);
+  }
+
+  std::array<std::byte, 8> output{};
+  ASSERT_EQ(6u, ringBuffer.read(output));
+  ASSERT_EQ(std::byte{5}, output[5]);
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(MirroredByteRingBufferTest, writeShouldStopWhenBufferIsFull)
+{
+  MirroredByteRingBuffer ringBuffer{1};
+  const std::vector<std::byte> bytes(ringBuffer.capacity() + 10);
+
+  ASSERT_EQ(ringBuffer.capacity(), ringBuffer.write(bytes));
+  ASSERT_TRUE(ringBuffer.isFull());
+  ASSERT_TRUE(ringBuffer.writable().empty());
+}
+
 }  // namespace cyclic_buffer
 
 namespace double_linked_list
@@ -527,16 +1351,532 @@ TEST_F(DoubleLinkedListTest, shouldDeleteLastElement)
   const std::string item2{"item2"};
   const std::string item3{"item3"};
 
-  list.pushLeft(item1);
-  list.pushLeft(item2);
-  list.pushLeft(item3);
+  list.pushLeft(item1);
+  list.pushLeft(item2);
+  list.pushLeft(item3);
+
+  list.deleteBack();
+
+  ASSERT_EQ(list.front().value(), item3);
+  ASSERT_EQ(list.back().value(), item2);
+  ASSERT_EQ(expectedListSize, list.size());
+}
+
+TEST(PooledDoubleLinkedListTest, shouldBehaveLikeHeapAllocatedListAndReuseNodesAfterClear)
+{
+  DoubleLinkedList<std::string, trace::NoTrace, it::PoolNodeAllocator> list;
+  for (int32_t round{}; round < 2; ++round)
+  {
+    list.pushRight("b");
+    list.pushLeft("a");
+    list.pushRight("d");
+    ASSERT_TRUE(list.putAfter("b", "c"));
+    ASSERT_TRUE(list.remove("a"));
+    list.deleteBack();
+
+    const std::vector<std::string> expected{"b", "c"};
+    ASSERT_EQ(expected.size(), list.size());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), list.begin(),
+                           [](const auto& item, const auto& node) { return item == node.item; }));
+    list.clear();
+    ASSERT_TRUE(list.isEmpty());
+  }
+}
+
+TEST(IndexedDoubleLinkedListTest, shouldKeepItemsUniqueAndOrdered)
+{
+  IndexedDoubleLinkedList<std::string> list;
+  ASSERT_TRUE(list.pushRight("b"));
+  ASSERT_TRUE(list.pushLeft("a"));
+  ASSERT_FALSE(list.pushRight("a"));
+  ASSERT_TRUE(list.putAfter("b", "d"));
+  ASSERT_TRUE(list.putBefore("d", "c"));
+  ASSERT_FALSE(list.putBefore("d", "a"));
+  ASSERT_FALSE(list.putAfter("x", "y"));
+
+  const std::vector<std::string> expected{"a", "b", "c", "d"};
+  ASSERT_EQ(expected.size(), list.size());
+  ASSERT_TRUE(std::equal(expected.begin(), expected.end(), list.begin(),
+                         [](const auto& item, const auto& node) { return item == node.item; }));
+  ASSERT_EQ("c", (*list.find("c"))->item);
+}
+
+TEST(IndexedDoubleLinkedListTest, nodesShouldBeReadOnlySoIndexStaysInSync)
+{
+  struct ModuloHash
+  {
+    size_t operator()(int32_t item) const { return static_cast<size_t>(item % 4); }
+  };
+  IndexedDoubleLinkedList<int32_t, trace::NoTrace, it::PoolNodeAllocator, ModuloHash> list;
+  static_assert(std::is_const_v<std::remove_reference_t<decltype(*list.begin())>>);
+  static_assert(std::is_same_v<std::optional<const DoubleNode<int32_t>*>, decltype(list.find(0))>);
+
+  for (int32_t i{}; i < 8; ++i)
+  {
+    list.pushRight(i);
+  }
+  ASSERT_EQ(5, (*list.find(5))->item);
+  ASSERT_EQ(28, std::accumulate(list.begin(), list.end(), 0,
+                                [](int32_t sum, const auto& node) { return sum + node.item; }));
+}
+
+TEST(IndexedDoubleLinkedListTest, removedAndDeletedItemsShouldLeaveIndex)
+{
+  IndexedDoubleLinkedList<int32_t> list;
+  for (int32_t i{}; i < 5; ++i)
+  {
+    list.pushRight(i);
+  }
+
+  ASSERT_TRUE(list.remove(2));
+  ASSERT_FALSE(list.remove(2));
+  list.deleteFront();
+  list.deleteBack();
+  ASSERT_EQ(std::nullopt, list.find(0));
+  ASSERT_EQ(std::nullopt, list.find(4));
+  ASSERT_EQ(2, list.size());
+
+  ASSERT_TRUE(list.pushLeft(4));
+  ASSERT_EQ(4, list.front());
+  list.clear();
+  ASSERT_FALSE(list.contains(1));
+  ASSERT_TRUE(list.pushRight(1));
+}
+
+struct Task : IntrusiveHook<Task>
+{
+  explicit Task(int32_t newId) : id{newId} {}
+
+  int32_t id{};
+};
+
+TEST(IntrusiveDoubleLinkedListTest, shouldLinkObjectsInPlaceAndIterateInOrder)
+{
+  std::vector<Task> tasks{Task{0}, Task{1}, Task{2}, Task{3}};
+  IntrusiveDoubleLinkedList<Task> list;
+  list.pushRight(tasks[1]);
+  list.pushRight(tasks[2]);
+  list.pushLeft(tasks[0]);
+  list.pushRight(tasks[3]);
+
+  ASSERT_EQ(4, list.size());
+  ASSERT_EQ(&tasks[0], list.front());
+  ASSERT_EQ(&tasks[3], list.back());
+
+  list.remove(tasks[2]);
+  list.deleteFront();
+  list.deleteBack();
+  ASSERT_EQ(1, list.size());
+  ASSERT_EQ(&tasks[1], list.front());
+  ASSERT_EQ(&tasks[1], &*list.begin());
+  ASSERT_EQ(nullptr, tasks[0].next);
+  ASSERT_EQ(nullptr, tasks[3].prev);
+
+  // Object can be moved to another list after unlinking
+  list.pushRight(tasks[2]);
+  list.deleteFront();
+  IntrusiveDoubleLinkedList<Task> other;
+  other.pushRight(tasks[1]);
+
+  std::vector<int32_t> ids;
+  std::transform(list.begin(), list.end(), std::back_inserter(ids),
+                 [](const Task& task) { return task.id; });
+  std::transform(other.begin(), other.end(), std::back_inserter(ids),
+                 [](const Task& task) { return task.id; });
+  ASSERT_EQ((std::vector<int32_t>{2, 1}), ids);
+}
+
+TEST(IntrusiveDoubleLinkedListTest, clearShouldUnlinkEveryObject)
+{
+  Task first{1};
+  Task second{2};
+  {
+    IntrusiveDoubleLinkedList<Task> list;
+    list.pushRight(first);
+    list.pushRight(second);
+
+    // Copy of linked object is not linked
+    const Task copy{first};
+    ASSERT_EQ(nullptr, copy.next);
+
+    list.clear();
+    ASSERT_TRUE(list.isEmpty());
+    ASSERT_EQ(nullptr, list.front());
+    ASSERT_EQ(nullptr, first.next);
+    ASSERT_EQ(nullptr, second.prev);
+
+    list.pushLeft(second);
+  }
+  ASSERT_EQ(nullptr, second.next);
+}
+
+TEST(UnrolledLinkedListTest, shouldMatchVectorAfterRandomInsertsAndRemovals)
+{
+  UnrolledLinkedList<int32_t> list;
+  std::vector<int32_t> expected;
+  std::mt19937 randomEngine{7};
+
+  for (int32_t i{}; i < 5'000; ++i)
+  {
+    const auto operation{randomEngine() % 4};
+    if (operation < 2 || expected.empty())
+    {
+      const size_t index{randomEngine() % (expected.size() + 1)};
+      ASSERT_TRUE(list.insert(index, i));
+      expected.insert(expected.begin() + static_cast<std::ptrdiff_t>(index), i);
+    }
+    else if (operation == 2)
+    {
+      const size_t index{randomEngine() % expected.size()};
+      ASSERT_EQ(expected[index], list.removeAt(index));
+      expected.erase(expected.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+    else
+    {
+      list.pushLeft(i);
+      expected.insert(expected.begin(), i);
+    }
+  }
+
+  ASSERT_EQ(expected.size(), list.size());
+  ASSERT_TRUE(std::equal(expected.begin(), expected.end(), list.begin(), list.end()));
+  ASSERT_FALSE(list.insert(expected.size() + 1, 0));
+  ASSERT_EQ(std::nullopt, list.removeAt(expected.size()));
+}
+
+TEST(UnrolledLinkedListTest, findShouldReturnPositionOfFirstOccurrence)
+{
+  UnrolledLinkedList<int32_t> list;
+  for (int32_t i{}; i < 1'000; ++i)
+  {
+    list.pushRight(i % 500);
+  }
+
+  ASSERT_EQ(0, list.find(0));
+  ASSERT_EQ(499, list.find(499));
+  ASSERT_EQ(std::nullopt, list.find(500));
+
+  ASSERT_TRUE(list.remove(499));
+  ASSERT_EQ(998, list.find(499));
+  ASSERT_EQ(999, list.size());
+}
+
+TEST(UnrolledLinkedListTest, shouldMergeChunksWhenDrainedAndWorkWithNonArithmeticItems)
+{
+  UnrolledLinkedList<std::string> list;
+  for (int32_t i{}; i < 100; ++i)
+  {
+    list.pushRight(std::to_string(i));
+  }
+  ASSERT_EQ(2, list.find("2"));
+
+  for (int32_t i{}; i < 49; ++i)
+  {
+    list.deleteFront();
+    list.deleteBack();
+  }
+  ASSERT_EQ("49", list.front());
+  ASSERT_EQ("50", list.back());
+  ASSERT_TRUE(list.remove("49"));
+  ASSERT_FALSE(list.remove("49"));
+  list.deleteBack();
+  ASSERT_TRUE(list.isEmpty());
+  ASSERT_EQ(list.end(), list.begin());
+  ASSERT_EQ(std::nullopt, list.front());
+}
+
+TEST(DoubleLinkedListSpliceTest, shouldMoveNodesBetweenListsAndKeepSizes)
+{
+  DoubleLinkedList<int32_t> list;
+  DoubleLinkedList<int32_t> other;
+  for (int32_t i{}; i < 3; ++i)
+  {
+    list.pushRight(i);
+    other.pushRight(10 + i);
+  }
+
+  // [10, 11, 12] moved before 1
+  const auto* const movedNode{&*other.begin()};
+  list.splice(list.begin() + 1, other);
+  ASSERT_TRUE(other.isEmpty());
+  ASSERT_EQ(movedNode, &*(list.begin() + 1));
+
+  // [11, 12] moved back to other
+  other.splice(other.end(), list, list.begin() + 2, list.begin() + 4);
+  const auto toVector{[](auto& l)
+                      {
+                        std::vector<int32_t> items;
+                        std::transform(l.begin(), l.end(), std::back_inserter(items),
+                                       [](const auto& node) { return node.item; });
+                        return items;
+                      }};
+  ASSERT_EQ((std::vector<int32_t>{0, 10, 1, 2}), toVector(list));
+  ASSERT_EQ((std::vector<int32_t>{11, 12}), toVector(other));
+  ASSERT_EQ(4, list.size());
+  ASSERT_EQ(2, other.size());
+
+  list.split(list.begin() + 2, other);
+  ASSERT_EQ((std::vector<int32_t>{0, 10}), toVector(list));
+  ASSERT_EQ((std::vector<int32_t>{11, 12, 1, 2}), toVector(other));
+  ASSERT_EQ(10, list.back());
+
+  list.append(other);
+  ASSERT_EQ((std::vector<int32_t>{0, 10, 11, 12, 1, 2}), toVector(list));
+  ASSERT_EQ(6, list.size());
+  list.deleteBack();
+  ASSERT_EQ(1, list.back());
+}
+
+static_assert(std::bidirectional_iterator<Iterator<DoubleNode<int32_t>>>);
+
+TEST(DoubleLinkedListIteratorTest, shouldWalkBackwardsFromEnd)
+{
+  DoubleLinkedList<int32_t> list;
+  for (int32_t i{}; i < 4; ++i)
+  {
+    list.pushRight(i);
+  }
+
+  std::vector<int32_t> reversed;
+  std::transform(std::make_reverse_iterator(list.end()), std::make_reverse_iterator(list.begin()),
+                 std::back_inserter(reversed), [](const auto& node) { return node.item; });
+  ASSERT_EQ((std::vector<int32_t>{3, 2, 1, 0}), reversed);
+
+  auto it{list.end()};
+  --it;
+  ASSERT_EQ(3, it->item);
+  ASSERT_EQ(list.begin(), std::prev(it, 3));
+}
+
+TEST(DoubleLinkedListIteratorTest, shouldFilterAndRewriteListInOnePass)
+{
+  DoubleLinkedList<int32_t> list;
+  for (int32_t i{}; i < 10; ++i)
+  {
+    list.pushRight(i);
+  }
+
+  // Drop odd items, put negative copy before and tenfold copy after multiples of 4
+  for (auto it{list.begin()}; it != list.end();)
+  {
+    if (it->item % 2 != 0)
+    {
+      it = list.erase(it);
+      continue;
+    }
+    if (it->item % 4 == 0)
+    {
+      list.insertBefore(it, -it->item);
+      it = list.insertAfter(it, 10 * it->item);
+    }
+    ++it;
+  }
+  list.insertBefore(list.end(), 100);
+
+  std::vector<int32_t> items;
+  std::transform(list.begin(), list.end(), std::back_inserter(items),
+                 [](const auto& node) { return node.item; });
+  ASSERT_EQ((std::vector<int32_t>{0, 0, 0, 2, -4, 4, 40, 6, -8, 8, 80, 100}), items);
+  ASSERT_EQ(items.size(), list.size());
+  ASSERT_EQ(100, list.back());
+  ASSERT_EQ(0, list.front());
+}
+
+TEST(DoubleLinkedListIteratorTest, insertAtEndShouldWorkOnEmptyAndNonEmptyList)
+{
+  DoubleLinkedList<int32_t> list;
+  ASSERT_EQ(1, list.insertAfter(list.begin(), 1)->item);
+  ASSERT_EQ(0, list.insertAfter(list.end(), 0)->item);
+  ASSERT_EQ(2, list.insertBefore(list.end(), 2)->item);
+
+  std::vector<int32_t> items;
+  std::transform(list.begin(), list.end(), std::back_inserter(items),
+                 [](const auto& node) { return node.item; });
+  ASSERT_EQ((std::vector<int32_t>{0, 1, 2}), items);
+  ASSERT_EQ(3, list.size());
+  ASSERT_EQ(nullptr, list.begin()->prev);
+  ASSERT_EQ(2, std::prev(list.end())->item);
+}
+
+TEST(CompactDoubleLinkedListTest, shouldReuseFreedSlotsAndKeepOrder)
+{
+  CompactDoubleLinkedList<int32_t> list;
+  for (int32_t i{}; i < 6; ++i)
+  {
+    list.pushRight(i);
+  }
+  ASSERT_TRUE(list.remove(2));
+  ASSERT_TRUE(list.remove(4));
+  list.deleteFront();
+  ASSERT_FALSE(list.remove(2));
+
+  list.pushLeft(10);
+  ASSERT_TRUE(list.putBefore(3, 11));
+  ASSERT_TRUE(list.putAfter(5, 12));
+  ASSERT_EQ(6, list.capacity());
+
+  std::vector<int32_t> items{list.begin(), list.end()};
+  ASSERT_EQ((std::vector<int32_t>{10, 1, 11, 3, 5, 12}), items);
+  ASSERT_EQ(12, list.back());
+  ASSERT_EQ(10, list.front());
+
+  std::vector<int32_t> reversed{std::make_reverse_iterator(list.end()),
+                                std::make_reverse_iterator(list.begin())};
+  ASSERT_EQ((std::vector<int32_t>{12, 5, 3, 11, 1, 10}), reversed);
+}
+
+TEST(CompactDoubleLinkedListTest, copyShouldBeIndependentAndIteratorEditsShouldBeLinear)
+{
+  CompactDoubleLinkedList<std::string, uint16_t> list{8};
+  for (int32_t i{}; i < 8; ++i)
+  {
+    list.pushRight(std::to_string(i));
+  }
+
+  CompactDoubleLinkedList<std::string, uint16_t> copy{list};
+  for (auto it{list.begin()}; it != list.end();)
+  {
+    it = (std::stoi(*it) % 2 == 0) ? list.erase(it) : std::next(list.insertAfter(it, *it + "'"));
+  }
+
+  ASSERT_EQ(8, list.size());
+  ASSERT_EQ("1'", *std::next(list.begin()));
+  ASSERT_EQ(8, copy.size());
+  ASSERT_EQ("0", copy.front());
+  list.clear();
+  ASSERT_TRUE(list.isEmpty());
+  ASSERT_EQ(list.begin(), list.end());
+  ASSERT_EQ(8, copy.size());
+}
+
+TEST(CompactDoubleLinkedListTest, moveShouldStealArraysAndLeaveSourceEmpty)
+{
+  CompactDoubleLinkedList<std::string> list{4};
+  list.pushRight("a");
+  list.pushRight("b");
+  const auto* const data{&*list.begin()};
+
+  CompactDoubleLinkedList<std::string> moved{std::move(list)};
+  ASSERT_EQ(2, moved.size());
+  ASSERT_EQ(data, &*moved.begin());
+  ASSERT_TRUE(list.isEmpty());  // NOLINT(bugprone-use-after-move)
+  ASSERT_EQ(list.begin(), list.end());
+  list.pushRight("c");
+  ASSERT_EQ("c", list.front());
+
+  list = std::move(moved);
+  ASSERT_EQ(2, list.size());
+  ASSERT_EQ("a", list.front());
+  ASSERT_EQ("b", list.back());
+  ASSERT_TRUE(moved.isEmpty());  // NOLINT(bugprone-use-after-move)
+}
+
+TEST(CompactDoubleLinkedListTest, insertAtEndShouldWorkOnEmptyAndNonEmptyList)
+{
+  CompactDoubleLinkedList<int32_t> list;
+  list.insertAfter(list.end(), 2);
+  list.insertBefore(list.end(), 3);
+  list.insertAfter(list.end(), 1);
+
+  ASSERT_EQ((std::vector<int32_t>{1, 2, 3}), (std::vector<int32_t>{list.begin(), list.end()}));
+  ASSERT_EQ(1, list.front());
+  ASSERT_EQ(3, list.back());
+}
+
+TEST(WorkStealingDequeTest, ownerShouldPopLifoThievesShouldStealFifoAndArrayShouldGrow)
+{
+  WorkStealingDeque<int32_t> deque{2};
+  ASSERT_EQ(std::nullopt, deque.popRight());
+  ASSERT_EQ(std::nullopt, deque.stealLeft());
+
+  for (int32_t i{}; i < 10; ++i)
+  {
+    deque.pushRight(i);
+  }
+  ASSERT_EQ(10, deque.size());
+  ASSERT_EQ(16, deque.capacity());
+
+  ASSERT_EQ(9, deque.popRight());
+  ASSERT_EQ(0, deque.stealLeft());
+  ASSERT_EQ(1, deque.stealLeft());
+  ASSERT_EQ(8, deque.popRight());
+  for (int32_t i{2}; i < 8; ++i)
+  {
+    ASSERT_EQ(i, deque.stealLeft());
+  }
+  ASSERT_EQ(std::nullopt, deque.popRight());
+  ASSERT_TRUE(deque.isEmpty());
+
+  // Indices keep running after the deque has been drained
+  deque.pushRight(42);
+  ASSERT_EQ(42, deque.popRight());
+  ASSERT_EQ(std::nullopt, deque.stealLeft());
+}
+
+TEST(WorkStealingDequeTest, everyItemShouldBeTakenExactlyOnceByOwnerOrThieves)
+{
+  constexpr size_t noOfThieves{3};
+  constexpr uint32_t noOfItems{100'000};
+
+  // Small initial array, so it grows while thieves are stealing
+  WorkStealingDeque<uint32_t> deque{4};
+  std::vector<std::atomic<uint32_t>> taken(noOfItems);
+  std::atomic<uint32_t> noOfTaken{};
+  std::atomic<uint32_t> noOfStolen{};
 
-  list.deleteBack();
+  std::vector<std::thread> thieves;
+  for (size_t t{}; t < noOfThieves; ++t)
+  {
+    thieves.emplace_back(
+        [&]
+        {
+          while (noOfTaken.load() < noOfItems)
+          {
+            if (const auto item{deque.stealLeft()})
+            {
+              taken[*item].fetch_add(1);
+              noOfTaken.fetch_add(1);
+              noOfStolen.fetch_add(1);
+              continue;
+            }
+            std::this_thread::yield();
+          }
+        });
+  }
 
-  ASSERT_EQ(list.front().value(), item3);
-  ASSERT_EQ(list.back().value(), item2);
-  ASSERT_EQ(expectedListSize, list.size());
+  // Owner pushes in bursts and pops part of every burst itself, the last item of a burst is contended
+  for (uint32_t i{}; i < noOfItems;)
+  {
+    const auto burstEnd{std::min(noOfItems, i + 64)};
+    for (; i < burstEnd; ++i)
+    {
+      deque.pushRight(i);
+    }
+    for (size_t p{}; p < 16; ++p)
+    {
+      if (const auto item{deque.popRight()})
+      {
+        taken[*item].fetch_add(1);
+        noOfTaken.fetch_add(1);
+      }
+    }
+    std::this_thread::yield();
+  }
+  while (const auto item{deque.popRight()})
+  {
+    taken[*item].fetch_add(1);
+    noOfTaken.fetch_add(1);
+  }
+  for (auto& thief : thieves)
+  {
+    thief.join();
+  }
+
+  ASSERT_TRUE(std::ranges::all_of(taken, [](const auto& count) { return count.load() == 1; }));
+  ASSERT_GT(noOfStolen.load(), 0);
+  ASSERT_TRUE(deque.isEmpty());
 }
+
 }  // namespace double_linked_list
 
 namespace queue
@@ -835,6 +2175,79 @@ INSTANTIATE_TEST_SUITE_P(QueueImplCopyConstructorTest, QueueImplCopyConstructorT
                                          std::vector<std::string>{"item1", "item2"},
                                          std::vector<std::string>{"item1", "item2", "item3", "item4"}));
 
+template <typename NodeAllocatorTag>
+struct QueueImplCopyMoveTest : public testing::Test
+{
+};
+
+template <template <typename> typename NodeAllocator>
+struct AllocatorTag
+{
+  template <typename T>
+  using Queue = QueueImpl<T, trace::NoTrace, NodeAllocator>;
+};
+
+using NodeAllocators =
+    testing::Types<AllocatorTag<it::HeapNodeAllocator>, AllocatorTag<it::PoolNodeAllocator>>;
+TYPED_TEST_SUITE(QueueImplCopyMoveTest, NodeAllocators);
+
+TYPED_TEST(QueueImplCopyMoveTest, copyOfLargeQueueShouldNotOverflowStack)
+{
+  constexpr uint32_t noOfItems{1'000'000};
+  typename TypeParam::template Queue<uint32_t> queue;
+  for (uint32_t i{}; i < noOfItems; ++i)
+  {
+    queue.enqueue(i);
+  }
+
+  auto copy{queue};
+  ASSERT_EQ(noOfItems, copy.size());
+  const auto values{std::views::iota(0U, noOfItems)};
+  ASSERT_TRUE(std::equal(values.begin(), values.end(), copy.begin(), copy.end(),
+                         [](uint32_t i, const auto& node) { return i == node.item; }));
+}
+
+TYPED_TEST(QueueImplCopyMoveTest, moveShouldTransferNodesAndLeaveSourceEmpty)
+{
+  using Queue = typename TypeParam::template Queue<std::string>;
+  static_assert(std::is_nothrow_move_constructible_v<Queue>);
+  static_assert(std::is_nothrow_move_assignable_v<Queue>);
+
+  Queue queue;
+  queue.enqueue("a");
+  queue.enqueue("b");
+  const auto* const front{&*queue.begin()};
+
+  std::vector<Queue> queues;
+  queues.push_back(std::move(queue));
+  ASSERT_TRUE(queue.isEmpty());
+  ASSERT_EQ(front, &*queues[0].begin());
+  ASSERT_EQ(2, queues[0].size());
+
+  // Moved-from queue is usable again
+  queue.enqueue("c");
+  queues[0] = std::move(queue);
+  ASSERT_TRUE(queue.isEmpty());
+  ASSERT_EQ(1, queues[0].size());
+  ASSERT_EQ("c", queues[0].dequeue());
+
+  queues[0].enqueue("d");
+  queue = queues[0];
+  queue = queue;
+  ASSERT_EQ("d", queue.dequeue());
+  ASSERT_EQ("d", queues[0].dequeue());
+  ASSERT_TRUE(queue.isEmpty());
+}
+
+TEST(RandomQueueTest, shouldBeMovable)
+{
+  RandomQueue<std::string> queue;
+  queue.enqueue("a");
+  RandomQueue<std::string> moved{std::move(queue)};
+  ASSERT_TRUE(queue.isEmpty());
+  ASSERT_EQ("a", moved.sample());
+}
+
 TEST(RandomQueueTest, shouldReturnRandomElement)
 {
   const std::vector<std::string> items{"item1", "item2", "item3", "item4"};
@@ -852,6 +2265,420 @@ TEST(RandomQueueTest, shouldReturnRandomElement)
     FAIL() << "Item not found in RandomQueue\n";
   }
 }
+
+TEST(PooledQueueTest, shouldKeepFifoOrderAndCopyIntoOwnPool)
+{
+  QueueImpl<std::string, trace::NoTrace, it::PoolNodeAllocator> queue;
+  for (int32_t i{}; i < 1000; ++i)
+  {
+    queue.enqueue(std::to_string(i));
+  }
+  ASSERT_EQ("500", queue.remove(500));
+
+  QueueImpl<std::string, trace::NoTrace, it::PoolNodeAllocator> queueCopy{queue};
+  queue.clear();
+  for (int32_t i{}; i < 1000; ++i)
+  {
+    if (i != 500)
+    {
+      ASSERT_EQ(std::to_string(i), queueCopy.dequeue());
+    }
+  }
+  ASSERT_TRUE(queueCopy.isEmpty());
+}
+
+TEST(QueueSpliceTest, appendAndSplitAfterShouldMoveNodesWithoutCopies)
+{
+  QueueImpl<std::string> queue;
+  QueueImpl<std::string> other;
+  for (int32_t i{}; i < 3; ++i)
+  {
+    queue.enqueue("q" + std::to_string(i));
+    other.enqueue("o" + std::to_string(i));
+  }
+
+  queue.append(other);
+  ASSERT_TRUE(other.isEmpty());
+  ASSERT_EQ(6, queue.size());
+
+  queue.splitAfter(queue.begin() + 1, other);
+  ASSERT_EQ(2, queue.size());
+  ASSERT_EQ(4, other.size());
+  queue.enqueue("q3");
+  other.enqueue("o3");
+
+  for (const auto* expected : {"q0", "q1", "q3"})
+  {
+    ASSERT_EQ(expected, queue.dequeue());
+  }
+  for (const auto* expected : {"q2", "o0", "o1", "o2", "o3"})
+  {
+    ASSERT_EQ(expected, other.dequeue());
+  }
+  ASSERT_TRUE(queue.isEmpty());
+  ASSERT_TRUE(other.isEmpty());
+}
+
+TEST(QueueSpliceTest, moveFrontToShouldTransferBatchInOrder)
+{
+  QueueImpl<int32_t> queue;
+  QueueImpl<int32_t> other;
+  for (int32_t i{}; i < 10; ++i)
+  {
+    queue.enqueue(i);
+  }
+  other.enqueue(-1);
+
+  queue.moveFrontTo(other, 4);
+  ASSERT_EQ(6, queue.size());
+  ASSERT_EQ(5, other.size());
+  queue.moveFrontTo(other, 100);
+  ASSERT_TRUE(queue.isEmpty());
+  queue.enqueue(10);
+
+  for (int32_t expected{-1}; expected < 10; ++expected)
+  {
+    ASSERT_EQ(expected, other.dequeue());
+  }
+  ASSERT_EQ(10, queue.dequeue());
+}
+
+TEST(RingQueueTest, shouldKeepFifoOrderWhileGrowingAcrossWrapPoint)
+{
+  RingQueue<std::string> queue{4};
+  ASSERT_EQ(4, queue.capacity());
+
+  // Move head forward so stored items wrap before growing
+  queue.enqueue("a");
+  queue.enqueue("b");
+  queue.enqueue("c");
+  ASSERT_EQ("a", queue.dequeue());
+  ASSERT_EQ("b", queue.dequeue());
+  for (int32_t i{}; i < 6; ++i)
+  {
+    queue.enqueue(std::to_string(i));
+  }
+
+  ASSERT_EQ(8, queue.capacity());
+  ASSERT_EQ(7, queue.size());
+  ASSERT_EQ("c", queue.dequeue());
+  for (int32_t i{}; i < 6; ++i)
+  {
+    ASSERT_EQ(std::to_string(i), queue.dequeue());
+  }
+  ASSERT_TRUE(queue.isEmpty());
+  ASSERT_EQ("", queue.dequeue());
+}
+
+TEST(RingQueueTest, removeShouldShiftShorterSideAndKeepOrder)
+{
+  RingQueue<int32_t> queue;
+  for (int32_t i{}; i < 10; ++i)
+  {
+    queue.enqueue(i);
+  }
+
+  ASSERT_EQ(std::nullopt, queue.remove(10));
+  ASSERT_EQ(2, queue.remove(2));
+  ASSERT_EQ(8, queue.remove(7));
+  ASSERT_EQ(0, queue.remove(0));
+
+  const std::vector<int32_t> expected{1, 3, 4, 5, 6, 7, 9};
+  ASSERT_EQ(expected.size(), queue.size());
+  for (size_t i{}; i < expected.size(); ++i)
+  {
+    ASSERT_EQ(expected[i], queue[i]);
+  }
+}
+
+TEST(RingQueueTest, shouldShrinkWhenSparseOnlyIfRequested)
+{
+  RingQueue<int32_t> growOnly;
+  RingQueue<int32_t> shrinking{0, true};
+  for (int32_t i{}; i < 64; ++i)
+  {
+    growOnly.enqueue(i);
+    shrinking.enqueue(i);
+  }
+  for (int32_t i{}; i < 60; ++i)
+  {
+    ASSERT_EQ(i, growOnly.dequeue());
+    ASSERT_EQ(i, shrinking.dequeue());
+  }
+
+  ASSERT_EQ(64, growOnly.capacity());
+  ASSERT_EQ(8, shrinking.capacity());
+  for (int32_t i{60}; i < 64; ++i)
+  {
+    ASSERT_EQ(i, shrinking.dequeue());
+  }
+}
+
+TEST(RingQueueTest, onlyQueuedItemsShouldBeAlive)
+{
+  using cyclic_buffer::LiveCounted;
+  {
+    RingQueue<LiveCounted> queue{2, true};
+    for (int32_t i{}; i < 20; ++i)
+    {
+      queue.enqueue(LiveCounted{i});
+    }
+    ASSERT_EQ(20, LiveCounted::noOfAlive);
+
+    ASSERT_EQ(5, queue.remove(5)->value);
+    ASSERT_EQ(0, queue.remove(0)->value);
+    ASSERT_EQ(18, LiveCounted::noOfAlive);
+  }
+  ASSERT_EQ(0, LiveCounted::noOfAlive);
+}
+
+static_assert(QueueType<QueueImpl<int32_t>>);
+static_assert(QueueType<RandomQueue<std::string>>);
+static_assert(FifoQueue<RingQueue<int32_t>> && !QueueType<RingQueue<int32_t>>);
+static_assert(FifoQueue<AnyQueue<int32_t>>);
+static_assert(!std::is_polymorphic_v<QueueImpl<int32_t>>);
+
+// Generic code over the static interface, same body for every queue
+std::vector<int32_t> rotateAndDrain(FifoQueue auto& queue, size_t noOfRotations)
+{
+  for (size_t i{}; i < noOfRotations; ++i)
+  {
+    queue.enqueue(queue.dequeue());
+  }
+  std::vector<int32_t> drained;
+  while (!queue.isEmpty())
+  {
+    drained.push_back(queue.dequeue());
+  }
+  return drained;
+}
+
+TEST(QueueConceptTest, staticAndTypeErasedQueuesShouldBehaveTheSame)
+{
+  QueueImpl<int32_t> linked;
+  RingQueue<int32_t> ring{2};
+  AnyQueue<int32_t> anyLinked{std::in_place_type<QueueImpl<int32_t>>};
+  AnyQueue<int32_t> anyRing{std::in_place_type<RingQueue<int32_t>>, 2, true};
+  for (int32_t i{}; i < 5; ++i)
+  {
+    linked.enqueue(i);
+    ring.enqueue(i);
+    anyLinked.enqueue(i);
+    anyRing.enqueue(i);
+  }
+  ASSERT_EQ(5, anyRing.size());
+  ASSERT_EQ(4, anyRing.remove(4));
+  ASSERT_EQ(std::nullopt, anyRing.remove(4));
+  anyRing.enqueue(4);
+
+  const std::vector<int32_t> expected{2, 3, 4, 0, 1};
+  ASSERT_EQ(expected, rotateAndDrain(linked, 2));
+  ASSERT_EQ(expected, rotateAndDrain(ring, 2));
+  ASSERT_EQ(expected, rotateAndDrain(anyLinked, 2));
+  ASSERT_EQ(expected, rotateAndDrain(anyRing, 2));
+  ASSERT_TRUE(anyLinked.isEmpty());
+}
+
+TEST(BlockQueueTest, removeShouldMatchReferenceModelAcrossBlocks)
+{
+  static_assert(QueueType<BlockQueue<int32_t>>);
+
+  BlockQueue<int32_t, trace::NoTrace, 4> queue;
+  std::vector<int32_t> model;
+  std::mt19937 randomEngine{3};
+  int32_t next{};
+  for (size_t step{}; step < 5'000; ++step)
+  {
+    const auto choice{randomEngine() % 8};
+    if (choice < 4)
+    {
+      queue.enqueue(next);
+      model.push_back(next++);
+    }
+    else if (choice < 6)
+    {
+      const auto item{queue.dequeue()};
+      ASSERT_EQ(model.empty() ? 0 : model.front(), item);
+      if (!model.empty())
+      {
+        model.erase(model.begin());
+      }
+    }
+    else
+    {
+      const size_t k{model.empty() ? 0 : randomEngine() % model.size()};
+      const auto removed{queue.remove(k)};
+      ASSERT_EQ(model.empty() ? std::nullopt : std::optional{model[k]}, removed);
+      if (!model.empty())
+      {
+        model.erase(model.begin() + static_cast<std::ptrdiff_t>(k));
+      }
+    }
+    ASSERT_EQ(model.size(), queue.size());
+    ASSERT_TRUE(std::equal(model.begin(), model.end(), queue.begin(), queue.end()));
+  }
+}
+
+TEST(BlockQueueTest, defaultCacheShouldKeepBlocksUpToHighWaterMark)
+{
+  BlockQueue<int32_t, trace::NoTrace, 4> queue;
+  for (int32_t round{}; round < 2; ++round)
+  {
+    for (int32_t i{}; i < 40; ++i)
+    {
+      queue.enqueue(i);
+    }
+    ASSERT_EQ(0, queue.noOfSpareBlocks());
+    for (int32_t i{}; i < 40; ++i)
+    {
+      ASSERT_EQ(i, queue.dequeue());
+    }
+    // Ten blocks at the peak, one stays as the empty queue's head
+    ASSERT_EQ(9, queue.noOfSpareBlocks());
+  }
+}
+
+TEST(BlockQueueTest, drainedBlocksShouldBeReusedAndItemsDestroyed)
+{
+  using cyclic_buffer::LiveCounted;
+  {
+    BlockQueue<LiveCounted, trace::NoTrace, 4> queue{2};
+    for (int32_t i{}; i < 20; ++i)
+    {
+      queue.enqueue(LiveCounted{i});
+    }
+    ASSERT_EQ(20, LiveCounted::noOfAlive);
+    ASSERT_EQ(0, queue.noOfSpareBlocks());
+
+    // Four blocks drained, cache keeps only two of them
+    for (int32_t i{}; i < 16; ++i)
+    {
+      ASSERT_EQ(i, queue.remove(0)->value);
+    }
+    ASSERT_EQ(2, queue.noOfSpareBlocks());
+    ASSERT_EQ(4, LiveCounted::noOfAlive);
+
+    // Enqueue takes cached blocks first, back item gets a block of its own
+    for (int32_t i{20}; i < 29; ++i)
+    {
+      queue.enqueue(LiveCounted{i});
+    }
+    ASSERT_EQ(0, queue.noOfSpareBlocks());
+    ASSERT_EQ(28, queue.remove(12)->value);
+    ASSERT_EQ(1, queue.noOfSpareBlocks());
+    ASSERT_EQ(23, queue.remove(7)->value);
+    ASSERT_EQ(11, LiveCounted::noOfAlive);
+
+    queue.clear();
+    ASSERT_TRUE(queue.isEmpty());
+    ASSERT_EQ(0, LiveCounted::noOfAlive);
+    queue.enqueue(LiveCounted{42});
+  }
+  ASSERT_EQ(0, LiveCounted::noOfAlive);
+}
+
+TEST(LockFreeQueueTest, protectedNodeShouldBeFreedOnlyAfterGuardIsReset)
+{
+  using cyclic_buffer::LiveCounted;
+  {
+    std::atomic<LiveCounted*> source{new LiveCounted{1}};
+    hazard::HazardPointer guard;
+    auto* const protectedNode{guard.protect(source)};
+
+    // Unlink and retire while guard still reads the node
+    hazard::retire(source.exchange(new LiveCounted{2}));
+    ASSERT_EQ(1, hazard::reclaim());
+    ASSERT_EQ(2, LiveCounted::noOfAlive);
+    ASSERT_EQ(1, protectedNode->value);
+
+    guard.reset();
+    ASSERT_EQ(0, hazard::reclaim());
+    ASSERT_EQ(1, LiveCounted::noOfAlive);
+    delete source.load();
+  }
+  ASSERT_EQ(0, LiveCounted::noOfAlive);
+}
+
+TEST(LockFreeQueueTest, shouldKeepFifoOrderAndFreeDequeuedNodes)
+{
+  static_assert(FifoQueue<LockFreeQueue<int32_t>> && !RemovableQueue<LockFreeQueue<int32_t>>);
+
+  LockFreeQueue<int32_t> queue;
+  ASSERT_EQ(std::nullopt, queue.tryDequeue());
+  ASSERT_EQ(0, queue.dequeue());
+  for (int32_t i{}; i < 5; ++i)
+  {
+    queue.enqueue(i);
+  }
+  ASSERT_EQ(5, queue.size());
+  ASSERT_EQ((std::vector<int32_t>{2, 3, 4, 0, 1}), rotateAndDrain(queue, 2));
+  ASSERT_TRUE(queue.isEmpty());
+  ASSERT_EQ(0, queue.size());
+  // No guard is held any more, so every dequeued dummy can go
+  ASSERT_EQ(0, hazard::reclaim());
+}
+
+TEST(LockFreeQueueTest, everyItemShouldBeReceivedExactlyOnceInProducerOrder)
+{
+  constexpr size_t noOfProducers{4};
+  constexpr size_t noOfConsumers{4};
+  constexpr uint64_t noOfItemsPerProducer{25'000};
+  constexpr uint64_t noOfItems{noOfProducers * noOfItemsPerProducer};
+
+  LockFreeQueue<uint64_t> queue;
+  std::vector<std::atomic<uint32_t>> received(noOfItems);
+  std::atomic<uint64_t> noOfReceived{};
+  std::atomic<size_t> noOfOrderViolations{};
+
+  std::vector<std::thread> threads;
+  for (size_t p{}; p < noOfProducers; ++p)
+  {
+    threads.emplace_back(
+        [&queue, p]
+        {
+          for (uint64_t i{p * noOfItemsPerProducer}; i < (p + 1) * noOfItemsPerProducer; ++i)
+          {
+            queue.enqueue(i);
+          }
+        });
+  }
+  for (size_t c{}; c < noOfConsumers; ++c)
+  {
+    threads.emplace_back(
+        [&]
+        {
+          // Items of one producer must reach every consumer in the order they were enqueued
+          std::array<uint64_t, noOfProducers> nextExpected{};
+          while (noOfReceived.load() < noOfItems)
+          {
+            const auto item{queue.tryDequeue()};
+            if (!item.has_value())
+            {
+              std::this_thread::yield();
+              continue;
+            }
+            const auto producer{*item / noOfItemsPerProducer};
+            if (*item % noOfItemsPerProducer < nextExpected[producer])
+            {
+              noOfOrderViolations.fetch_add(1);
+            }
+            nextExpected[producer] = *item % noOfItemsPerProducer + 1;
+            received[*item].fetch_add(1);
+            noOfReceived.fetch_add(1);
+          }
+        });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  ASSERT_EQ(0, noOfOrderViolations.load());
+  ASSERT_TRUE(std::ranges::all_of(received, [](const auto& count) { return count.load() == 1; }));
+  ASSERT_TRUE(queue.isEmpty());
+  ASSERT_EQ(0, queue.size());
+}
+
 }  // namespace queue
 
 namespace efficient_stack
@@ -1126,8 +2953,180 @@ TEST_F(DoubleLinkedListStackTest, iterateThroughStack)
     --i;
   }
 }
+
+TEST(PooledStackTest, shouldPopInLifoOrderAndPushAgainAfterClear)
+{
+  Stack<std::string, trace::NoTrace, it::PoolNodeAllocator> stack;
+  for (int32_t i{}; i < 1000; ++i)
+  {
+    stack.push(std::to_string(i));
+  }
+  for (int32_t i{999}; i >= 500; --i)
+  {
+    ASSERT_EQ(std::to_string(i), stack.pop());
+  }
+  stack.clear();
+  ASSERT_TRUE(stack.isEmpty());
+
+  stack.push("again");
+  ASSERT_EQ(1, stack.size());
+  ASSERT_EQ("again", stack.pop());
+}
+
+TEST(StackSpliceTest, appendShouldPutOtherStackOnTopAndSplitAfterShouldMoveLowerItems)
+{
+  Stack<int32_t> stack;
+  Stack<int32_t> other;
+  stack.push(1);
+  stack.push(2);
+  other.push(3);
+  other.push(4);
+
+  stack.append(other);
+  ASSERT_TRUE(other.isEmpty());
+  ASSERT_EQ(4, stack.size());
+
+  // 4 3 | 2 1
+  stack.splitAfter(stack.begin() + 1, other);
+  ASSERT_EQ(2, stack.size());
+  ASSERT_EQ(2, other.size());
+
+  // Bottom pointers of both stacks have to stay valid
+  other.append(stack);
+  ASSERT_EQ(4, other.size());
+  for (int32_t expected : {4, 3, 2, 1})
+  {
+    ASSERT_EQ(expected, other.pop());
+  }
+  other.push(5);
+  stack.append(other);
+  ASSERT_EQ(5, stack.pop());
+  ASSERT_TRUE(stack.isEmpty());
+}
+
+TEST(StackSpliceTest, moveTopToShouldKeepOrderOfMovedItems)
+{
+  Stack<int32_t> stack;
+  Stack<int32_t> other;
+  for (int32_t i{}; i < 5; ++i)
+  {
+    stack.push(i);
+  }
+  other.push(-1);
+
+  stack.moveTopTo(other, 2);
+  ASSERT_EQ(3, stack.size());
+  for (int32_t expected : {4, 3, -1})
+  {
+    ASSERT_EQ(expected, other.pop());
+  }
+  stack.moveTopTo(other, 3);
+  ASSERT_TRUE(stack.isEmpty());
+  other.push(7);
+  stack.append(other);
+  for (int32_t expected : {7, 2, 1, 0})
+  {
+    ASSERT_EQ(expected, stack.pop());
+  }
+}
+
 }  // namespace linked_list_stack
 
+namespace move_to_front
+{
+TEST(MoveToFrontTest, byteEncoderShouldEmitPositionsAndDecoderShouldRestoreInput)
+{
+  const std::vector<uint8_t> input{'a', 'a', 'a', 'b', 'a', 'b', 255, 0};
+  std::vector<uint8_t> encoded(input.size());
+  std::vector<uint8_t> decoded(input.size());
+
+  ByteEncoder encoder;
+  encoder.encode(input, encoded);
+  ASSERT_EQ((std::vector<uint8_t>{'a', 0, 0, 'b', 1, 1, 255, 3}), encoded);
+
+  ByteDecoder decoder;
+  decoder.decode(encoded, decoded);
+  ASSERT_EQ(input, decoded);
+
+  std::vector<uint8_t> tooShort(input.size() - 1);
+  ASSERT_THROW(encoder.encode(input, tooShort), std::invalid_argument);
+}
+
+TEST(MoveToFrontTest, chunkedStreamShouldMatchWholeBufferAndFilesShouldRoundTrip)
+{
+  std::mt19937 generator{7};
+  std::geometric_distribution<uint32_t> distribution{0.05};
+  std::vector<uint8_t> input(100'000);
+  std::ranges::generate(input, [&] { return static_cast<uint8_t>(distribution(generator)); });
+
+  std::vector<uint8_t> whole(input.size());
+  ByteEncoder{}.encode(input, whole);
+
+  ByteEncoder encoder;
+  ByteDecoder decoder;
+  std::vector<uint8_t> chunked(input.size());
+  std::vector<uint8_t> decoded(input.size());
+  // Chunks of 1, 4, 13, 40... bytes
+  for (size_t begin{}, chunkSize{1}; begin < input.size(); chunkSize = 3 * chunkSize + 1)
+  {
+    const auto size{std::min(chunkSize, input.size() - begin)};
+    encoder.encode(std::span{input}.subspan(begin, size), std::span{chunked}.subspan(begin));
+    decoder.decode(std::span{chunked}.subspan(begin, size), std::span{decoded}.subspan(begin));
+    begin += size;
+  }
+  ASSERT_EQ(whole, chunked);
+  ASSERT_EQ(input, decoded);
+
+  const auto inputPath{testing::TempDir() + "mtf_input"};
+  const auto encodedPath{testing::TempDir() + "mtf_encoded"};
+  const auto decodedPath{testing::TempDir() + "mtf_decoded"};
+  {
+    std::ofstream file{inputPath, std::ios::binary};
+    file.write(reinterpret_cast<const char*>(input.data()), static_cast<std::streamsize>(input.size()));
+  }
+  encodeFile(inputPath, encodedPath);
+  decodeFile(encodedPath, decodedPath);
+  std::ifstream file{decodedPath, std::ios::binary};
+  const std::vector<uint8_t> fromFile{std::istreambuf_iterator<char>{file},
+                                      std::istreambuf_iterator<char>{}};
+  ASSERT_EQ(input, fromFile);
+  ASSERT_THROW(encodeFile(testing::TempDir() + "mtf_missing", encodedPath), std::system_error);
+}
+
+TEST(MoveToFrontTest, alphabetCoderShouldMatchByteCoderAndRoundTripLargeAlphabet)
+{
+  std::mt19937 generator{11};
+  std::vector<uint8_t> bytes(5'000);
+  std::ranges::generate(bytes, [&] { return static_cast<uint8_t>(generator() % 40); });
+  std::vector<uint8_t> byteRanks(bytes.size());
+  ByteEncoder{}.encode(bytes, byteRanks);
+
+  AlphabetEncoder byteAlphabet{256};
+  for (size_t i{}; i < bytes.size(); ++i)
+  {
+    ASSERT_EQ(byteRanks[i], byteAlphabet.encode(bytes[i]));
+  }
+
+  // Many more symbols than the alphabet size, so the timeline gets renumbered a lot
+  constexpr size_t alphabetSize{1'000};
+  std::geometric_distribution<uint32_t> distribution{0.01};
+  std::vector<uint32_t> symbols(50'000);
+  std::ranges::generate(symbols, [&] { return distribution(generator) % alphabetSize; });
+  std::vector<uint32_t> ranks(symbols.size());
+  std::vector<uint32_t> decoded(symbols.size());
+  AlphabetEncoder encoder{alphabetSize};
+  AlphabetDecoder decoder{alphabetSize};
+  encoder.encode(symbols, ranks);
+  decoder.decode(ranks, decoded);
+  ASSERT_EQ(symbols, decoded);
+
+  ASSERT_THROW(std::ignore = encoder.encode(alphabetSize), std::out_of_range);
+  ASSERT_THROW(std::ignore = decoder.decode(alphabetSize), std::out_of_range);
+  ASSERT_THROW(AlphabetEncoder{0}, std::invalid_argument);
+}
+
+}  // namespace move_to_front
+
 namespace homework
 {
 